@@ -10,6 +10,8 @@
 
 #include "bxlx/recognize/graph_traits.hpp"
 
+#include <functional>
+
 #if (defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
 #define HAS_BXLX_GRAPH_EXCEPTIONS
 #else
@@ -156,6 +158,78 @@ namespace detail {
         type_traits::range_type_v<container_type<G, Traits, true>> == type_traits::range_type_t::set_like ||
         type_traits::range_type_v<container_type<G, Traits, true>> == type_traits::range_type_t::map_like;
 
+  template<class Cmp, class = void>
+  constexpr bool is_transparent_v = false;
+  template<class Cmp>
+  constexpr bool is_transparent_v<Cmp, std::void_t<typename Cmp::is_transparent>> = true;
+
+  // the ordered containers with transparent comparator find by any comparable key, the unordered ones have no key_compare
+  template<class Cont, class = void>
+  constexpr bool has_transparent_compare_v = false;
+  template<class Cont>
+  constexpr bool has_transparent_compare_v<Cont, std::void_t<typename Cont::key_compare>> =
+        is_transparent_v<typename Cont::key_compare>;
+
+  // the ordered containers which keep their keys in ascending order of operator<
+  template<class Cont, class = void>
+  constexpr bool has_less_compare_v = false;
+  template<class Cont>
+  constexpr bool has_less_compare_v<Cont, std::enable_if_t<std::is_same_v<typename Cont::key_compare, std::less<>> ||
+                                                           std::is_same_v<typename Cont::key_compare,
+                                                                          std::less<typename Cont::key_type>>>> = true;
+
+  // the nodes of an associative node container with transparent comparator are found by any comparable key
+  template<class G, class Traits, class Key, class = void>
+  constexpr bool is_transparent_node_key_v = false;
+  template<class G, class Traits, class Key>
+  constexpr bool is_transparent_node_key_v<G, Traits, Key, std::enable_if_t<
+    is_associative<node_container_t, G, Traits> && !std::is_same_v<std::decay_t<Key>, node_t<G, Traits, true>>>> =
+        has_transparent_compare_v<std::remove_cv_t<node_container_t<G, Traits, true>>>;
+
+  // ordered associative edge lists keep the edges of one source next to each other
+  template<class G, class Traits, class = void>
+  constexpr bool has_ordered_sources_v = false;
+  template<class G, class Traits>
+  constexpr bool has_ordered_sources_v<G, Traits, std::enable_if_t<has_edge_list_container_v<G, Traits> &&
+                                                                   is_associative<edge_list_container_t, G, Traits>>> = [] {
+    using container_t = std::remove_cv_t<edge_list_container_t<G, Traits>>;
+    using key_t = typename container_t::key_type;
+    using compare_t = typename container_t::key_compare;
+    if constexpr (type_traits::is_tuple_v<key_t>) {
+      return std::is_same_v<std::remove_cv_t<std::tuple_element_t<0, key_t>>, node_t<G, Traits>> &&
+             (std::is_same_v<compare_t, std::less<key_t>> || std::is_same_v<compare_t, std::less<>>);
+    } else {
+      return false;
+    }
+  }();
+
+  // adjacency matrices of index nodes whose rows are bitsets: one compressed bitset or a container of bitset rows
+  template<class G, class Traits, class = void>
+  constexpr bool has_bitset_rows_v = false;
+  template<class G, class Traits>
+  constexpr bool has_bitset_rows_v<G, Traits, std::enable_if_t<
+    representation_v<G, Traits> == representation_t::adjacency_matrix && !has_in_adjacency_container_v<G, Traits> &&
+    !is_user_defined_node_type_v<G, Traits>>> = type_traits::is_bitset_v<adjacency_container_t<G, Traits, true>>;
+
+  // adjacency matrices of index nodes with rows of cells, where a cell is an optional edge or a range of multi edges
+  template<class G, class Traits, class = void>
+  constexpr bool has_cell_rows_v = false;
+  template<class G, class Traits>
+  constexpr bool has_cell_rows_v<G, Traits, std::enable_if_t<
+    representation_v<G, Traits> == representation_t::adjacency_matrix && has_node_container_v<G, Traits> &&
+    !has_in_adjacency_container_v<G, Traits> && !is_user_defined_node_type_v<G, Traits>>> =
+        !type_traits::is_bitset_v<adjacency_container_t<G, Traits, true>>;
+
+  // an edge is stored in the cell
+  template<class Cell>
+  constexpr bool cell_present(Cell const& cell) {
+    if constexpr (type_traits::is_range_v<Cell>) {
+      return std::begin(cell) != std::end(cell);
+    } else {
+      return static_cast<bool>(cell);
+    }
+  }
+
 
   template <class T>
   constexpr T sqrt_helper(T x, T lo, T hi) {
@@ -196,6 +270,76 @@ namespace detail {
     return k * (k-1) / 2 == n;
   }
 
+  // Row layout of an adjacency matrix which is compressed into one bitset, in the node_count precedence.
+  //  square:   k*k bits, row i is [i*k, (i+1)*k).
+  //  no_self:  k*(k-1) bits without the diagonal, row i is [i*(k-1), (i+1)*(k-1)), the i. column is skipped.
+  //  triangle: k*(k-1)/2 bits of an undirected graph without the diagonal. Row i holds the edges to the j < i nodes
+  //            from i*(i-1)/2, the edges to the j > i nodes are the i. column of the later rows.
+  enum class compressed_layout { square, no_self, triangle, invalid };
+
+  struct compressed_matrix {
+    constexpr static std::size_t npos = ~std::size_t{};
+
+    std::size_t k{};
+    compressed_layout layout = compressed_layout::invalid;
+
+    constexpr compressed_matrix() noexcept = default;
+
+    constexpr explicit compressed_matrix(std::size_t size) noexcept {
+      if (is_square_num(size)) {
+        k = constexpr_sqrt(size);
+        layout = compressed_layout::square;
+      } else if (is_k_x_km1(size)) {
+        k = constexpr_sqrt_no_self(size);
+        layout = compressed_layout::no_self;
+      } else if (is_k_x_km1_d_2(size)) {
+        k = constexpr_sqrt_no_self(size * 2);
+        layout = compressed_layout::triangle;
+      }
+    }
+
+    constexpr std::size_t row_begin(std::size_t i) const noexcept {
+      switch (layout) {
+        case compressed_layout::square: return i * k;
+        case compressed_layout::no_self: return i * (k - 1);
+        case compressed_layout::triangle: return i * (i - 1) / 2;
+        default: return 0;
+      }
+    }
+
+    constexpr std::size_t row_end(std::size_t i) const noexcept {
+      return row_begin(i + 1);
+    }
+
+    // the target node of the bit of row i
+    constexpr std::size_t target(std::size_t i, std::size_t bit) const noexcept {
+      const std::size_t j = bit - row_begin(i);
+      return j + (layout == compressed_layout::no_self && j >= i);
+    }
+
+    // the bit of the (from, to) edge, npos on the diagonal of the layouts which has no diagonal
+    constexpr std::size_t index(std::size_t from, std::size_t to) const noexcept {
+      switch (layout) {
+        case compressed_layout::square: return from * k + to;
+        case compressed_layout::no_self: return from == to ? npos : from * (k - 1) + to - (to > from);
+        case compressed_layout::triangle: return from == to ? npos : from > to ? row_begin(from) + to : row_begin(to) + from;
+        default: return npos;
+      }
+    }
+  };
+
+  // The shape of a compressed matrix. For the constant sized bitsets it is computed at compile time, otherwise the
+  // square root searches run once per call, so the traversals keep the result instead of calling it per node.
+  template<class G, class Traits>
+  constexpr compressed_matrix compressed_matrix_of([[maybe_unused]] std::size_t size) noexcept {
+    if constexpr (has_constexpr_size<adjacency_container_t, G, Traits>) {
+      constexpr compressed_matrix res{get_constexpr_size<adjacency_container_t, G, Traits>};
+      return res;
+    } else {
+      return compressed_matrix{size};
+    }
+  }
+
   template<class, class = void>
   constexpr inline auto constexpr_number = [] { throw; };
   template<class T>
@@ -265,7 +409,7 @@ constexpr std::size_t max_node_size_v<G, Traits, true,
       detail::is_k_x_km1(detail::get_constexpr_size<adjacency_container_t, G, Traits>)
       ? detail::constexpr_sqrt_no_self(detail::get_constexpr_size<adjacency_container_t, G, Traits>) :
       detail::is_k_x_km1_d_2(detail::get_constexpr_size<adjacency_container_t, G, Traits>)
-      ? detail::constexpr_sqrt_no_self(detail::get_constexpr_size<adjacency_container_t, G, Traits> * 2) + 1 :
+      ? detail::constexpr_sqrt_no_self(detail::get_constexpr_size<adjacency_container_t, G, Traits> * 2) :
                   [] () -> std::size_t { throw; }();
 
 template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>, class = void>
@@ -337,6 +481,91 @@ template<class G, class Traits>
 constexpr bool parallel_edges_v<G, Traits, true, std::void_t<typename Traits::multi_edge::type>>
       = Traits::multi_edge::type::value;
 
+// The adjacency rows are ordered by the target node, so the edge lookups can use binary search.
+// Associative rows are sorted by nature, other graph types can opt in with a specialization.
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>, class = void>
+constexpr bool sorted_adjacency_v = false;
+
+template<class G, class Traits>
+constexpr bool sorted_adjacency_v<G, Traits, true, std::enable_if_t<detail::is_associative<adjacency_container_t, G, Traits>>>
+      = true;
+
+// Cost class of a primitive operation on a graph type, in growing order. The size of the result is not counted, so
+// the out_edges of an adjacency list costs constant: the row is found without touching other edges.
+//  constant:    O(1)
+//  logarithmic: O(log) search in an ordered container
+//  degree:      O(deg) scan of one adjacency row
+//  nodes:       O(V) scan of one matrix row or column
+//  edges:       O(E) scan of all edges
+// Algorithms compare them in if constexpr to decide whether a temporary index pays for itself, and users can
+// static_assert(out_edges_cost_v<G> < cost_t::edges) on the graph types of their hot paths.
+enum class cost_t { constant, logarithmic, degree, nodes, edges };
+
+namespace detail {
+  template<class G, class Traits>
+  constexpr cost_t node_lookup_cost() {
+    if constexpr (is_associative<node_container_t, G, Traits>) {
+      return cost_t::logarithmic;
+    } else {
+      return cost_t::constant;
+    }
+  }
+
+  template<class G, class Traits>
+  constexpr cost_t out_edges_cost() {
+    if constexpr (representation_v<G, Traits> == representation_t::adjacency_matrix) {
+      return cost_t::nodes;
+    } else if constexpr (has_adjacency_container_v<G, Traits>) {
+      return node_lookup_cost<G, Traits>();
+    } else if constexpr (has_ordered_sources_v<G, Traits>) {
+      return cost_t::logarithmic;
+    } else {
+      return cost_t::edges;
+    }
+  }
+
+  template<class G, class Traits>
+  constexpr cost_t in_edges_cost() {
+    if constexpr (has_in_adjacency_container_v<G, Traits>) {
+      return representation_v<G, Traits> == representation_t::adjacency_matrix ? cost_t::nodes : node_lookup_cost<G, Traits>();
+    } else if constexpr (has_bitset_rows_v<G, Traits>) {
+      return cost_t::nodes;
+    } else {
+      return cost_t::edges;
+    }
+  }
+
+  template<class G, class Traits>
+  constexpr cost_t has_edge_cost() {
+    if constexpr (representation_v<G, Traits> == representation_t::adjacency_matrix) {
+      return cost_t::constant;
+    } else if constexpr (has_adjacency_container_v<G, Traits>) {
+      if constexpr (is_associative<adjacency_container_t, G, Traits> || sorted_adjacency_v<std::remove_cv_t<G>, Traits>) {
+        return cost_t::logarithmic;
+      } else {
+        return cost_t::degree;
+      }
+    } else if constexpr (is_associative<edge_list_container_t, G, Traits>) {
+      return cost_t::logarithmic;
+    } else {
+      return cost_t::edges;
+    }
+  }
+}
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr cost_t out_edges_cost_v = detail::out_edges_cost<G, Traits>();
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr cost_t in_edges_cost_v = detail::in_edges_cost<G, Traits>();
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr cost_t has_edge_cost_v = detail::has_edge_cost<G, Traits>();
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr cost_t node_count_cost_v = has_node_container_v<G, Traits> || has_adjacency_container_v<G, Traits>
+                                     ? cost_t::constant : cost_t::edges;
+
 template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
 constexpr bool directed_edges_v = detail::directed_edges<G, Traits>::value;
 
@@ -0,0 +1,368 @@
+//
+// Copyright (c) 2022-2023 Bela Schaum (schaumb at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BXLX_GRAPH_CSR_HPP
+#define BXLX_GRAPH_CSR_HPP
+
+#include "bxlx/algorithms/detail/getters.hpp"
+
+#include <map>
+#include <vector>
+
+namespace bxlx::graph {
+
+namespace detail {
+  // Without node properties the rows are the node_count + 1 entry offset array itself, stored as pointers into the
+  // targets: a row ends where the next one begins. Such a row is meaningful only in its array, so it is not copyable.
+  template<class T, bool with_end>
+  struct csr_row {
+    using value_type = T;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    const T* first;
+
+    constexpr csr_row(const T* first = nullptr) noexcept : first(first) {}
+    csr_row(csr_row const&) = delete;
+    csr_row& operator=(csr_row const&) = delete;
+
+    constexpr const_iterator begin() const noexcept {
+      return first;
+    }
+
+    constexpr const_iterator end() const noexcept {
+      return (this + 1)->first;
+    }
+
+    constexpr std::size_t size() const noexcept {
+      return static_cast<std::size_t>(end() - first);
+    }
+  };
+
+  // the rows next to a node property keep their own end
+  template<class T>
+  struct csr_row<T, true> {
+    using value_type = T;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    const T* first;
+    const T* last;
+
+    constexpr const_iterator begin() const noexcept {
+      return first;
+    }
+
+    constexpr const_iterator end() const noexcept {
+      return last;
+    }
+
+    constexpr std::size_t size() const noexcept {
+      return static_cast<std::size_t>(last - first);
+    }
+  };
+
+  template<class Index, class Prop>
+  struct csr_value {
+    using type = std::pair<Index, Prop>;
+  };
+  template<class Index>
+  struct csr_value<Index, void> {
+    using type = Index;
+  };
+
+  template<class Index, class Prop>
+  using csr_value_t = typename csr_value<Index, Prop>::type;
+}
+
+// Compressed sparse row snapshot of a graph.
+//
+// Every out edge is stored in one contiguous array grouped by the source node, row i covers offsets(i) ..
+// offsets(i+1). Without node properties the rows are the node_count + 1 offsets (as pointers into the targets), with
+// node properties every row holds its [begin, end) range next to the property. It is a random access range of rows,
+// which graph_traits recognizes as an adjacency_list; edge properties are stored next to the target, node properties
+// next to the row, exactly where the adjacency_list recognition looks for them.
+//
+// When the source graph has user defined nodes, the original node keys are kept in a sorted side array, so
+// key(index) and index_of(key) translate between the two.
+template<class Index = std::size_t, class EdgeProp = void, class NodeProp = void, class Key = Index>
+class csr {
+public:
+  using index_type = Index;
+  using key_type = Key;
+  using target_type = detail::csr_value_t<Index, EdgeProp>;
+  using row_type = detail::csr_row<target_type, !std::is_void_v<NodeProp>>;
+  using value_type = std::conditional_t<std::is_void_v<NodeProp>, row_type, std::pair<row_type, NodeProp>>;
+  using iterator = typename std::vector<value_type>::const_iterator;
+  using const_iterator = iterator;
+
+  csr() = default;
+  csr(csr&&) noexcept = default;
+  csr& operator=(csr&&) noexcept = default;
+
+  csr(csr const& oth)
+        : targets(oth.targets), keys(oth.keys) {
+    copy_rows(oth);
+  }
+
+  csr& operator=(csr const& oth) {
+    if (this != &oth) {
+      targets = oth.targets;
+      keys = oth.keys;
+      copy_rows(oth);
+    }
+    return *this;
+  }
+
+  // Takes the already grouped targets and the edge count of each node.
+  // The rows are built with one prefix sum, the targets are not moved in memory.
+  template<class Degrees>
+  csr(std::vector<target_type>&& targets, Degrees const& degrees, std::vector<Key>&& keys = {})
+        : targets(std::move(targets)), keys(std::move(keys)) {
+    std::size_t n{}, offset{};
+    if constexpr (std::is_void_v<NodeProp>) {
+      rows = std::vector<value_type>(std::size(degrees) + 1);
+      for (auto&& degree : degrees) {
+        rows[n++].first = this->targets.data() + offset;
+        offset += degree;
+      }
+      rows[n].first = this->targets.data() + offset;
+    } else {
+      rows.reserve(std::size(degrees));
+      for (auto&& degree : degrees) {
+        rows.emplace_back(row_type{this->targets.data() + offset, this->targets.data() + offset + degree}, NodeProp{});
+        offset += degree;
+      }
+    }
+  }
+
+  constexpr const_iterator begin() const noexcept {
+    return rows.begin();
+  }
+
+  constexpr const_iterator end() const noexcept {
+    return rows.begin() + static_cast<std::ptrdiff_t>(size());
+  }
+
+  // the sentinel row of the offsets is not a node
+  constexpr std::size_t size() const noexcept {
+    if constexpr (std::is_void_v<NodeProp>) {
+      return rows.empty() ? 0 : rows.size() - 1;
+    } else {
+      return rows.size();
+    }
+  }
+
+  constexpr std::size_t edge_size() const noexcept {
+    return targets.size();
+  }
+
+  constexpr std::size_t offsets(Index node) const noexcept {
+    if (static_cast<std::size_t>(node) < size())
+      return static_cast<std::size_t>(row(node).first - targets.data());
+    return targets.size();
+  }
+
+  constexpr row_type const& row(Index node) const noexcept {
+    if constexpr (std::is_void_v<NodeProp>) {
+      return rows[node];
+    } else {
+      return rows[node].first;
+    }
+  }
+
+  template<class NP = NodeProp>
+  constexpr std::enable_if_t<!std::is_void_v<NP>, NP&> node_property(Index node) noexcept {
+    return rows[node].second;
+  }
+
+  template<class NP = NodeProp>
+  constexpr std::enable_if_t<!std::is_void_v<NP>, NP const&> node_property(Index node) const noexcept {
+    return rows[node].second;
+  }
+
+  template<class EP = EdgeProp>
+  constexpr std::enable_if_t<!std::is_void_v<EP>, EP&> edge_property(std::size_t offset) noexcept {
+    return targets[offset].second;
+  }
+
+  template<class EP = EdgeProp>
+  constexpr std::enable_if_t<!std::is_void_v<EP>, EP const&> edge_property(std::size_t offset) const noexcept {
+    return targets[offset].second;
+  }
+
+  constexpr std::conditional_t<std::is_same_v<Key, Index>, Key, Key const&> key(Index node) const noexcept {
+    if constexpr (std::is_same_v<Key, Index>) {
+      return node;
+    } else {
+      return keys[node];
+    }
+  }
+
+  constexpr Index index_of(Key const& key) const {
+    if constexpr (std::is_same_v<Key, Index>) {
+      return key;
+    } else {
+      if (auto it = std::lower_bound(keys.begin(), keys.end(), key); it != keys.end() && !(key < *it))
+        return static_cast<Index>(it - keys.begin());
+      detail::throw_or_terminate<std::out_of_range>("Cannot find node");
+    }
+  }
+
+private:
+  // the rows of the copy point into its own targets
+  void copy_rows(csr const& oth) {
+    const auto rebase = [this, &oth] (const target_type* ptr) {
+      return targets.data() + (ptr - oth.targets.data());
+    };
+    if constexpr (std::is_void_v<NodeProp>) {
+      rows = std::vector<value_type>(oth.rows.size());
+      for (std::size_t i{}; i < rows.size(); ++i)
+        rows[i].first = rebase(oth.rows[i].first);
+    } else {
+      rows = oth.rows;
+      for (auto& [r, prop] : rows)
+        r = row_type{rebase(r.first), rebase(r.last)};
+    }
+  }
+
+  std::vector<target_type> targets;
+  std::vector<value_type> rows;
+  std::vector<Key> keys;
+};
+
+namespace detail {
+  template<class G, class Traits, class = void>
+  struct csr_edge_prop {
+    using type = void;
+  };
+  template<class G, class Traits>
+  struct csr_edge_prop<G, Traits, std::enable_if_t<has_edge_property_v<G, Traits>>> {
+    using type = std::remove_cv_t<edge_property_t<G, Traits>>;
+  };
+
+  template<class G, class Traits, class = void>
+  struct csr_node_prop {
+    using type = void;
+  };
+  template<class G, class Traits>
+  struct csr_node_prop<G, Traits, std::enable_if_t<has_node_property_v<G, Traits>>> {
+    using type = std::remove_cv_t<node_property_t<G, Traits>>;
+  };
+
+  template<class Index, class G, class Traits>
+  using csr_index_t = std::conditional_t<!std::is_void_v<Index>, Index,
+                                         std::conditional_t<is_user_defined_node_type_v<G, Traits>, std::size_t, node_t<G, Traits>>>;
+
+  template<class Index, class G, class Traits>
+  using csr_for_t = csr<csr_index_t<Index, G, Traits>,
+                        typename csr_edge_prop<G, Traits>::type,
+                        typename csr_node_prop<G, Traits>::type,
+                        std::conditional_t<is_user_defined_node_type_v<G, Traits>, node_t<G, Traits>, csr_index_t<Index, G, Traits>>>;
+}
+
+// Builds a csr snapshot from any recognized graph.
+// Edge lists are read with two passes over the list, every other representation with two passes over out_edges;
+// the edge properties are read through the edge representation of the out edge iterator, without a second lookup.
+template<class Index = void, class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+auto make_csr(G const& g) -> detail::csr_for_t<Index, G, Traits> {
+  using result_t = detail::csr_for_t<Index, G, Traits>;
+  using index_t = typename result_t::index_type;
+  using target_t = typename result_t::target_type;
+  using key_t = typename result_t::key_type;
+  using node_type = node_t<G, Traits>;
+
+  std::vector<key_t> keys;
+  // the user defined nodes are numbered in their order
+  [[maybe_unused]] std::conditional_t<is_user_defined_node_type_v<G, Traits>, std::map<node_type, index_t>, std::nullptr_t> ids{};
+  std::size_t n{};
+
+  const auto index = [&ids] (node_type const& node) -> index_t {
+    if constexpr (is_user_defined_node_type_v<G, Traits>) {
+      return ids.find(node)->second;
+    } else {
+      return static_cast<index_t>(node);
+    }
+  };
+
+  const auto for_each_edge = [&g] (auto&& fun) {
+    if constexpr (has_edge_list_container_v<G, Traits>) {
+      auto&& list = edge_list(g);
+      for (auto it = std::begin(list), end = std::end(list); it != end; ++it) {
+        if constexpr (has_edge_property_v<G, Traits>) {
+          fun(detail::source_getter<const G, Traits>{}(it), detail::target_getter<const G, Traits>{}(it),
+              detail::edge_property_getter<const G, Traits>{}(it));
+        } else {
+          fun(detail::source_getter<const G, Traits>{}(it), detail::target_getter<const G, Traits>{}(it));
+        }
+      }
+    } else {
+      for (node_type from : node_indices(g)) {
+        for (auto [to, repr] : out_edges(g, from)) {
+          if constexpr (has_edge_property_v<G, Traits>) {
+            fun(from, to, edge_property(g, repr));
+          } else {
+            fun(from, to);
+          }
+        }
+      }
+    }
+  };
+
+  if constexpr (is_user_defined_node_type_v<G, Traits>) {
+    if constexpr (has_node_container_v<G, Traits> || has_adjacency_container_v<G, Traits>) {
+      for (node_type node : node_indices(g))
+        ids.try_emplace(node);
+    } else {
+      for_each_edge([&ids] (node_type const& from, node_type const& to, auto&&...) {
+        ids.try_emplace(from);
+        ids.try_emplace(to);
+      });
+    }
+    keys.reserve(ids.size());
+    for (auto& [key, id] : ids) {
+      id = static_cast<index_t>(keys.size());
+      keys.push_back(key);
+    }
+    n = keys.size();
+  } else {
+    n = node_count(g);
+  }
+
+  std::vector<std::size_t> degrees(n);
+  for_each_edge([&] (node_type const& from, auto&&...) {
+    ++degrees[index(from)];
+  });
+
+  std::vector<std::size_t> offsets(n);
+  std::size_t sum{};
+  for (std::size_t i{}; i < n; ++i) {
+    offsets[i] = sum;
+    sum += degrees[i];
+  }
+
+  std::vector<target_t> targets(sum);
+  for_each_edge([&] (node_type const& from, node_type const& to, auto&&... prop) {
+    if constexpr (sizeof...(prop) == 0) {
+      targets[offsets[index(from)]++] = index(to);
+    } else {
+      targets[offsets[index(from)]++] = target_t{index(to), prop...};
+    }
+  });
+
+  result_t res{std::move(targets), degrees, std::move(keys)};
+
+  if constexpr (has_node_property_v<G, Traits>) {
+    for (node_type node : node_indices(g))
+      res.node_property(index(node)) = node_property(g, node);
+  }
+  return res;
+}
+
+}
+
+#endif //BXLX_GRAPH_CSR_HPP
@@ -99,6 +99,18 @@ namespace detail {
 
   template<class G, class Traits = graph_traits<G>>
   constexpr bool all_edge_has_both_direction(G const& g) {
+    if constexpr (has_sortable_adjacency_v<const G, Traits>) {
+      if (!sorted_adjacency_v<std::remove_cv_t<G>, Traits> && adjacency_rows_sorted<const G, Traits>(g)) {
+        for (node_t<G, Traits> n : node_indices(g)) {
+          for (auto [to, repr] : out_edges(g, n)) {
+            auto* adj = adjacents(&g, to);
+            if (!adj || find_adjacent<const G, Traits>(*adj, n, true) == std::end(*adj))
+              return false;
+          }
+        }
+        return true;
+      }
+    }
     for (node_t<G, Traits> n : node_indices(g)) {
       for (auto [to, repr] : out_edges(g, n)) {
         if (!has_edge(g, to, n))
@@ -10,6 +10,325 @@
 
 #include "../interface.hpp"
 
+#include <bitset>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
+namespace bxlx::graph::detail {
+  template<class Word>
+  constexpr std::size_t countr_zero(Word word) noexcept {
+    static_assert(std::is_unsigned_v<Word> && sizeof(Word) <= sizeof(std::uint64_t));
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long res{};
+    _BitScanForward64(&res, word);
+    return res;
+#else
+    std::size_t res{};
+    while (!(word & Word{1})) {
+      word >>= 1;
+      ++res;
+    }
+    return res;
+#endif
+  }
+
+  template<class Word>
+  constexpr std::size_t popcount(Word word) noexcept {
+    static_assert(std::is_unsigned_v<Word> && sizeof(Word) <= sizeof(std::uint64_t));
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_popcountll(word));
+#elif defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__)
+    return static_cast<std::size_t>(__popcnt64(word));
+#else
+    std::uint64_t x = word;
+    x -= (x >> 1) & 0x5555555555555555ull;
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<std::size_t>((x * 0x0101010101010101ull) >> 56);
+#endif
+  }
+
+  // The lowest len bits, len <= 64.
+  constexpr std::uint64_t low_bits(std::size_t len) noexcept {
+    return len < 64 ? (std::uint64_t{1} << len) - 1 : ~std::uint64_t{};
+  }
+
+  // First set bit in [from, to) of a little endian packed word array, or to if there is none.
+  // Reads only the words which overlap the range.
+  template<class Word>
+  constexpr std::size_t find_next_set_word(const Word* words, std::size_t from, std::size_t to) noexcept {
+    constexpr std::size_t bits = sizeof(Word) * CHAR_BIT;
+    if (from >= to)
+      return to;
+
+    std::size_t ix = from / bits;
+    const std::size_t last = (to - 1) / bits;
+    Word word = words[ix] & static_cast<Word>(~Word{} << (from % bits));
+    while (!word) {
+      if (++ix > last)
+        return to;
+#if defined(__AVX2__)
+      if constexpr (sizeof(Word) == sizeof(std::uint64_t)) {
+        for (; ix + 4 <= last + 1; ix += 4) {
+          const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + ix));
+          if (!_mm256_testz_si256(chunk, chunk))
+            break;
+        }
+        if (ix > last)
+          return to;
+      }
+#endif
+      word = words[ix];
+    }
+    const std::size_t res = ix * bits + countr_zero(word);
+    return res < to ? res : to;
+  }
+
+  // Number of set bits in [from, to) of a little endian packed word array.
+  template<class Word>
+  constexpr std::size_t count_set_word(const Word* words, std::size_t from, std::size_t to) noexcept {
+    constexpr std::size_t bits = sizeof(Word) * CHAR_BIT;
+    if (from >= to)
+      return 0;
+
+    std::size_t ix = from / bits;
+    const std::size_t last = (to - 1) / bits;
+    const Word first_mask = static_cast<Word>(~Word{} << (from % bits));
+    const Word last_mask = static_cast<Word>(~Word{} >> (bits - 1 - (to - 1) % bits));
+    if (ix == last)
+      return popcount(static_cast<Word>(words[ix] & first_mask & last_mask));
+
+    std::size_t res = popcount(static_cast<Word>(words[ix] & first_mask));
+    ++ix;
+#if defined(__AVX2__)
+    if constexpr (sizeof(Word) == sizeof(std::uint64_t)) {
+      // nibble lookup popcount, the byte counts are summed up by _mm256_sad_epu8
+      const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                              0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+      const __m256i low_mask = _mm256_set1_epi8(0x0f);
+      __m256i sum = _mm256_setzero_si256();
+      for (; ix + 4 <= last; ix += 4) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + ix));
+        const __m256i counts = _mm256_add_epi8(
+              _mm256_shuffle_epi8(lookup, _mm256_and_si256(chunk, low_mask)),
+              _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), low_mask)));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+      }
+      res += static_cast<std::size_t>(_mm256_extract_epi64(sum, 0)) + static_cast<std::size_t>(_mm256_extract_epi64(sum, 1)) +
+             static_cast<std::size_t>(_mm256_extract_epi64(sum, 2)) + static_cast<std::size_t>(_mm256_extract_epi64(sum, 3));
+    }
+#endif
+    for (; ix < last; ++ix)
+      res += popcount(words[ix]);
+    return res + popcount(static_cast<Word>(words[last] & last_mask));
+  }
+
+  // Word level access of the bitsets which store their bits in a little endian packed word array.
+  // get returns the first word and the bit offset of index 0.
+  template<class T, class = void>
+  struct bitset_words {
+    constexpr static bool value = false;
+  };
+
+  // user defined packed bitsets, which expose their words
+  template<class T>
+  struct bitset_words<T, std::enable_if_t<std::is_pointer_v<decltype(std::declval<T const&>().words())>>> {
+    using word_type = std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<T const&>().words())>>;
+    constexpr static bool value = std::is_unsigned_v<word_type>;
+
+    constexpr static std::pair<const word_type*, std::size_t> get(T const& bitset) {
+      return {bitset.words(), 0};
+    }
+  };
+
+  template<class T>
+  constexpr inline bool is_std_bitset_v = false;
+
+  template<std::size_t N>
+  constexpr inline bool is_std_bitset_v<std::bitset<N>> = true;
+
+#if defined(BXLX_GRAPH_LIBSTDCXX_BIT_ACCESS) && defined(__GLIBCXX__)
+  // libstdc++ std::vector<bool>, the iterator holds the word pointer and the bit offset.
+  // These are implementation details, used only when BXLX_GRAPH_LIBSTDCXX_BIT_ACCESS is defined.
+  template<class T>
+  struct bitset_words<T, std::void_t<decltype(std::begin(std::declval<T const&>())._M_p),
+                                     decltype(std::size_t{std::begin(std::declval<T const&>())._M_offset})>> {
+    using word_type = std::remove_cv_t<std::remove_pointer_t<decltype(std::begin(std::declval<T const&>())._M_p)>>;
+    constexpr static bool value = std::is_unsigned_v<word_type>;
+
+    constexpr static std::pair<const word_type*, std::size_t> get(T const& bitset) {
+      auto it = std::begin(bitset);
+      return {it._M_p, it._M_offset};
+    }
+  };
+
+  // libstdc++ std::bitset is a standard layout class of its unsigned long word array.
+  // _Find_next is not used, it does not stop at the end of the range, which is a row of a compressed matrix.
+  template<std::size_t N>
+  struct bitset_words<std::bitset<N>, std::enable_if_t<(N > 64)>> {
+    using word_type = unsigned long;
+    constexpr static bool value = std::is_standard_layout_v<std::bitset<N>> &&
+          sizeof(std::bitset<N>) * CHAR_BIT == (N + sizeof(word_type) * CHAR_BIT - 1) / (sizeof(word_type) * CHAR_BIT) *
+                                               sizeof(word_type) * CHAR_BIT;
+
+    static std::pair<const word_type*, std::size_t> get(std::bitset<N> const& bitset) {
+      return {reinterpret_cast<const word_type*>(std::addressof(bitset)), 0};
+    }
+  };
+#endif
+
+  // std::bitset has no word access, up to 64 bits the whole bitset is read at once by to_ullong
+  template<class T>
+  constexpr inline bool is_word_sized_bitset_v = false;
+
+  template<std::size_t N>
+  constexpr inline bool is_word_sized_bitset_v<std::bitset<N>> = 0 < N && N <= 64;
+
+  // to_ullong is not constexpr before C++23, the constant evaluation takes the bits one by one
+  constexpr bool is_constant_evaluated() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(__has_builtin)
+#  if __has_builtin(__builtin_is_constant_evaluated)
+    return __builtin_is_constant_evaluated();
+#  else
+    return true;
+#  endif
+#else
+    return true;
+#endif
+  }
+
+  template<class T>
+  constexpr inline bool has_bitset_words_v = bitset_words<std::remove_cv_t<T>>::value;
+
+  // The word access of std::bitset is not constexpr, the constant evaluation takes the bits one by one.
+  // Without a word access, std::bitset wider than 64 bits and std::vector<bool> (unless BXLX_GRAPH_LIBSTDCXX_BIT_ACCESS
+  // is defined on libstdc++) are also tested bit by bit.
+  template<class T>
+  constexpr bool can_read_words() noexcept {
+    if constexpr (has_bitset_words_v<T>)
+      return !is_std_bitset_v<std::remove_cv_t<T>> || !is_constant_evaluated();
+    else
+      return false;
+  }
+
+  // First set bit in [from, to) of a bitset, or to if there is none.
+  template<class T>
+  constexpr std::size_t find_next_set(T& bitset, std::size_t from, std::size_t to) {
+    if (from >= to)
+      return to;
+
+    if constexpr (has_bitset_words_v<T>) {
+      if (can_read_words<T>()) {
+        auto [words, offset] = bitset_words<std::remove_cv_t<T>>::get(bitset);
+        return find_next_set_word(words, from + offset, to + offset) - offset;
+      }
+    } else if constexpr (is_word_sized_bitset_v<std::remove_cv_t<T>>) {
+      if (!is_constant_evaluated()) {
+        const std::uint64_t word = bitset.to_ullong() >> from & low_bits(to - from);
+        return word ? from + countr_zero(word) : to;
+      }
+    }
+    while (from < to && !bitset[from])
+      ++from;
+    return from;
+  }
+
+  // Number of set bits in [from, to) of a bitset.
+  template<class T>
+  constexpr std::size_t count_set(T& bitset, std::size_t from, std::size_t to) {
+    if (from >= to)
+      return 0;
+
+    if constexpr (is_std_bitset_v<std::remove_cv_t<T>>) {
+      // the whole bitset, the edges of a bitset matrix, is counted by the library
+      if (!is_constant_evaluated() && from == 0 && to == bitset.size())
+        return bitset.count();
+    }
+    if constexpr (has_bitset_words_v<T>) {
+      if (can_read_words<T>()) {
+        auto [words, offset] = bitset_words<std::remove_cv_t<T>>::get(bitset);
+        return count_set_word(words, from + offset, to + offset);
+      }
+    } else if constexpr (is_word_sized_bitset_v<std::remove_cv_t<T>>) {
+      if (!is_constant_evaluated())
+        return popcount(bitset.to_ullong() >> from & low_bits(to - from));
+    }
+    std::size_t res{};
+    for (; from < to; ++from)
+      res += static_cast<bool>(bitset[from]);
+    return res;
+  }
+
+  // Bits [from, to) of a bitset in one word, to - from <= 64.
+  template<class T>
+  constexpr std::uint64_t read_bits(T& bitset, std::size_t from, std::size_t to) {
+    std::uint64_t res{};
+    if constexpr (has_bitset_words_v<T>) {
+      if (can_read_words<T>()) {
+        auto [words, offset] = bitset_words<std::remove_cv_t<T>>::get(bitset);
+        constexpr std::size_t bits = sizeof(*words) * CHAR_BIT;
+        for (std::size_t shift{}, ix = from + offset, last = to + offset; ix < last; ) {
+          const std::size_t len = std::min(bits - ix % bits, last - ix);
+          res |= (static_cast<std::uint64_t>(words[ix / bits] >> ix % bits) & low_bits(len)) << shift;
+          shift += len;
+          ix += len;
+        }
+        return res;
+      }
+    } else if constexpr (is_word_sized_bitset_v<std::remove_cv_t<T>>) {
+      if (!is_constant_evaluated() && from < to)
+        return bitset.to_ullong() >> from & low_bits(to - from);
+    }
+    for (std::size_t i{}; from + i < to; ++i)
+      res |= std::uint64_t{static_cast<bool>(bitset[from + i])} << i;
+    return res;
+  }
+
+  // In place transpose of a 64x64 bit block, bit c of word r is the (r, c) element.
+  // The quadrants are swapped recursively with masked shifts; the steps which pair words at least 4 apart are done
+  // 4 words at once with AVX2.
+  inline void transpose_block(std::uint64_t (&block)[64]) noexcept {
+    std::uint64_t mask = 0x00000000FFFFFFFFull;
+    for (std::size_t j = 32; j; j >>= 1, mask ^= mask << j) {
+      std::size_t k{};
+#if defined(__AVX2__)
+      if (j >= 4) {
+        const __m256i m = _mm256_set1_epi64x(static_cast<long long>(mask));
+        const __m128i s = _mm_cvtsi64_si128(static_cast<long long>(j));
+        for (; k < 64; k = ((k | j) + 4) & ~j) {
+          __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + k));
+          __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + (k | j)));
+          const __m256i t = _mm256_and_si256(_mm256_xor_si256(_mm256_srl_epi64(lo, s), hi), m);
+          lo = _mm256_xor_si256(lo, _mm256_sll_epi64(t, s));
+          hi = _mm256_xor_si256(hi, t);
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(block + k), lo);
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(block + (k | j)), hi);
+        }
+      }
+#endif
+      for (; k < 64; k = ((k | j) + 1) & ~j) {
+        const std::uint64_t t = ((block[k] >> j) ^ block[k | j]) & mask;
+        block[k] ^= t << j;
+        block[k | j] ^= t;
+      }
+    }
+  }
+}
+
 namespace bxlx::graph::iterator {
   template<class T, class which_bits,
             class Index, bool is_const>
@@ -38,21 +357,24 @@ namespace bxlx::graph::iterator {
     }
 
     constexpr bitset_iterator& operator++ () {
-      if (get_bool())
-        do {
-          ++index;
-        } while (max > index && !**this);
+      if (get_bool()) {
+        if constexpr (std::is_same_v<which_bits, good_bits>) {
+          index = static_cast<Index>(detail::find_next_set(*obj, static_cast<std::size_t>(index) + 1,
+                                                           static_cast<std::size_t>(max)));
+        } else {
+          do {
+            ++index;
+          } while (max > index && !**this);
+        }
+      }
       return *this;
     }
   };
 
   template<class T>
   constexpr bitset_iterator<T> get_first_good(T& bitset, std::size_t from = 0, std::size_t to = ~std::size_t{}) {
-    bitset_iterator<T> r {&bitset, from, std::min(to, std::size(bitset))};
-    while (r.index < r.max && !bitset[r.index]) {
-      ++r.index;
-    }
-    return r;
+    std::size_t max = std::min(to, std::size(bitset));
+    return {&bitset, detail::find_next_set(bitset, from, max), max};
   }
 
   template<class T, class U, class WhichBits, class Index, bool is_const, bool other_const>
@@ -61,6 +383,13 @@ namespace bxlx::graph::iterator {
         bitset_iterator<U, WhichBits, Index, other_const> const& rhs) {
     return (lhs.get_bool() || rhs.get_bool()) && (lhs.obj != rhs.obj || lhs.index != rhs.index);
   }
+
+  template<class T, class U, class WhichBits, class Index, bool is_const, bool other_const>
+  constexpr std::enable_if_t<std::is_same_v<std::remove_const_t<T>, std::remove_const_t<U>>, bool> operator == (
+        bitset_iterator<T, WhichBits, Index, is_const> const& lhs,
+        bitset_iterator<U, WhichBits, Index, other_const> const& rhs) {
+    return !(lhs != rhs);
+  }
 }
 
 #endif //BXLX_GRAPH_BITSET_ITERATOR_HPP
@@ -3,43 +3,93 @@
 
 #include "../interface.hpp"
 #include "bitset_iterator.hpp"
+#include "edge_repr.hpp"
 #include "getter_types.hpp"
+#include "node_iterator.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace bxlx::graph::detail {
+// a key of the source, the other members are value initialized
+template<class Key, class Node, std::size_t ...Is>
+constexpr Key source_key(Node const& from, std::index_sequence<Is...>) {
+  return Key{from, std::tuple_element_t<Is + 1, Key>{}...};
+}
+
+// the iterables which yield the neighbours in ascending order (by operator<) declare a true static ascending member
+template<class It, class = void>
+constexpr bool is_ascending_v = false;
+template<class It>
+constexpr bool is_ascending_v<It, std::enable_if_t<It::ascending>> = true;
+}
 
 namespace bxlx::graph::iterator {
 
+// One bitset compressed matrix, see detail::compressed_layout.
+// The row segment is scanned word by word; in the triangle layout the edges to the later nodes are stored in the
+// mirrored half, so after the row the column of the node is walked through the later rows.
 template<class G, class Traits>
 struct edge_iterable<G, Traits, std::enable_if_t<!has_node_container_v<G, Traits> && has_adjacency_container_v<G, Traits>>> {
+  constexpr static bool ascending = true;
+
   G& g;
   node_t<G, Traits> start;
+  // the shape kept by the caller, computed by begin() if it is not given
+  detail::compressed_matrix shape{};
 
   struct const_iterator {
     using iterator_category = std::forward_iterator_tag;
-    using value_type = std::pair<node_t<G, Traits>, /*edge_repr_t<G, Traits>*/ void*>;
+    using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
     using difference_type = std::ptrdiff_t;
     using pointer = const value_type*;
     using reference = const value_type&;
 
     iterator::bitset_iterator<adjacency_container_t<G, Traits>> it;
-    node_t<G, Traits> start;
+    detail::compressed_matrix m{};
+    std::size_t start{};
+    // the next row of the column walk, 0 while the row segment is scanned
+    std::size_t column{};
 
     constexpr bool operator!=(const_iterator const& rhs) const {
       return it != rhs.it;
     }
 
     constexpr const_iterator& operator++() {
-      ++it;
+      if (column) {
+        walk(column);
+      } else if (++it; !it.get_bool() && m.layout == detail::compressed_layout::triangle) {
+        walk(start + 1);
+      }
       return *this;
     }
 
     constexpr value_type operator*() const noexcept {
-      return {it.index - start, nullptr};
+      return {static_cast<node_t<G, Traits>>(column ? column - 1 : m.target(start, it.index)), it};
+    }
+
+    constexpr void walk(std::size_t from) {
+      const std::size_t size = std::size(*it.obj);
+      for (column = from; column < m.k; ++column) {
+        if (const std::size_t ix = m.index(column, start); (*it.obj)[ix]) {
+          it = {it.obj, ix, size};
+          ++column;
+          return;
+        }
+      }
+      it = {it.obj, size, size};
     }
   };
 
   constexpr const_iterator begin() const {
-    auto c = node_count(g);
-    return {iterator::get_first_good(detail::adjacent_container_getter<G, Traits>{}(g),
-                                     start * c, (start+1)*c), start * c};
+    auto&& bits = detail::adjacent_container_getter<G, Traits>{}(g);
+    const detail::compressed_matrix m = shape.layout != detail::compressed_layout::invalid
+                                        ? shape : detail::compressed_matrix_of<G, Traits>(std::size(bits));
+    const auto s = static_cast<std::size_t>(start);
+    const_iterator res{iterator::get_first_good(bits, m.row_begin(s), m.row_end(s)), m, s};
+    if (!res.it.get_bool() && m.layout == detail::compressed_layout::triangle)
+      res.walk(s + 1);
+    return res;
   }
 
   constexpr const_iterator end() const {
@@ -51,23 +101,58 @@ struct edge_iterable<G, Traits, std::enable_if_t<!has_node_container_v<G, Traits
   }
 };
 
+template<class G, class Traits, bool in_edges>
+struct adjacency_of {
+  using type = adjacency_container_t<G, Traits>;
+
+  constexpr static auto get(G* g, node_t<G, Traits> const& node) {
+    return adjacents(g, node);
+  }
+};
+
 template<class G, class Traits>
-struct edge_iterable<G, Traits, std::enable_if_t<has_node_container_v<G, Traits> && has_adjacency_container_v<G, Traits>>> {
+struct adjacency_of<G, Traits, true> {
+  using type = in_adjacency_container_t<G, Traits>;
+
+  constexpr static auto get(G* g, node_t<G, Traits> const& node) {
+    return in_adjacents(g, node);
+  }
+};
+
+// the in adjacency rows are not edge representations, those are available only through the edge container
+template<class G, class Traits, bool in_edges>
+using adjacency_repr_t = std::conditional_t<!in_edges || has_edge_container_v<G, Traits>, edge_repr_t<G, Traits>, void*>;
+
+template<class G, class Traits, bool in_edges, class = void>
+struct adjacency_iterable {
+  // matrix rows are in node order, associative rows are ordered by their comparator, the others are sorted on opt-in
+  constexpr static bool ascending = [] {
+    using row_t = std::remove_cv_t<typename adjacency_of<G, Traits, in_edges>::type>;
+    if constexpr (representation_v<G, Traits> == representation_t::adjacency_matrix) {
+      return !is_user_defined_node_type_v<G, Traits>;
+    } else if constexpr (type_traits::range_type_v<row_t> == type_traits::range_type_t::set_like ||
+                         type_traits::range_type_v<row_t> == type_traits::range_type_t::map_like) {
+      return detail::has_less_compare_v<row_t>;
+    } else {
+      return !in_edges && sorted_adjacency_v<std::remove_cv_t<G>, Traits>;
+    }
+  }();
+
   G& g;
   node_t<G, Traits> start;
 
   struct const_iterator {
     using iterator_category = std::forward_iterator_tag;
-    using value_type = std::pair<node_t<G, Traits>, void* /*, edge_repr_t<G, Traits> */>;
+    using value_type = std::pair<node_t<G, Traits>, adjacency_repr_t<G, Traits, in_edges>>;
     using difference_type = std::ptrdiff_t;
     using pointer = const value_type*;
-    using reference = const value_type&;
+    using reference = std::pair<detail::node_ref_t<G, Traits>, adjacency_repr_t<G, Traits, in_edges>>;
 
-    using wrapper_it = std::conditional_t<std::is_const_v<G>,
-                                          typename adjacency_container_t<G, Traits>::const_iterator,
-                                          typename adjacency_container_t<G, Traits>::iterator>;
+    using wrapper_it = type_traits::detail::std_begin_t<std::conditional_t<std::is_const_v<G>,
+                                                                           const typename adjacency_of<G, Traits, in_edges>::type,
+                                                                           typename adjacency_of<G, Traits, in_edges>::type>>;
     G* g;
-    wrapper_it start, it;
+    wrapper_it start, it, last;
 
     constexpr bool operator!=(const_iterator const& rhs) const {
       return it != rhs.it;
@@ -75,36 +160,42 @@ struct edge_iterable<G, Traits, std::enable_if_t<has_node_container_v<G, Traits>
 
     constexpr const_iterator& operator++() {
       ++it;
+      return skip();
+    }
+
+    // the empty cells of a matrix row are not edges
+    constexpr const_iterator& skip() {
+      if constexpr (representation_v<G, Traits> == representation_t::adjacency_matrix)
+        while (it != last && !detail::cell_present(*it))
+          ++it;
       return *this;
     }
 
-    constexpr value_type operator*() const {
-      /*edge_repr_t<G, Traits> edge_repr;
+    constexpr reference operator*() const {
+      adjacency_repr_t<G, Traits, in_edges> edge_repr{};
       if constexpr (has_edge_container_v<G, Traits>) {
-        edge_repr = get_edge(g, detail::edge_index_getter<G, Traits>{}(it));
-      } else {
+        edge_repr = get_edge(*g, detail::edge_index_getter<G, Traits>{}(it));
+      } else if constexpr (!in_edges) {
         edge_repr = it;
-      }*/
-      node_t<G, Traits> node;
+      }
       if constexpr (is_user_defined_node_type_v<G, Traits> || representation_v<G, Traits> != representation_t::adjacency_matrix) {
-        node = detail::composition_t<detail::first_getter_t, detail::indirect_t>{}(it);
+        return {detail::composition_t<detail::first_getter_t, detail::indirect_t>{}(it), edge_repr};
       } else {
-        node = std::distance(start, it);
+        return {static_cast<node_t<G, Traits>>(std::distance(start, it)), edge_repr};
       }
-      return {node, nullptr};
     }
   };
 
   constexpr const_iterator begin() const {
-    if (auto has_adj = adjacents(&g, start)) {
-      return {&g, std::begin(*has_adj), std::begin(*has_adj)};
+    if (auto has_adj = adjacency_of<G, Traits, in_edges>::get(&g, start)) {
+      return const_iterator{&g, std::begin(*has_adj), std::begin(*has_adj), std::end(*has_adj)}.skip();
     }
     return {};
   }
 
   constexpr const_iterator end() const {
-    if (auto has_adj = adjacents(&g, start)) {
-      return {&g, std::begin(*has_adj), std::end(*has_adj)};
+    if (auto has_adj = adjacency_of<G, Traits, in_edges>::get(&g, start)) {
+      return {&g, std::begin(*has_adj), std::end(*has_adj), std::end(*has_adj)};
     }
     return {};
   }
@@ -114,6 +205,66 @@ struct edge_iterable<G, Traits, std::enable_if_t<has_node_container_v<G, Traits>
   }
 };
 
+// Bitset rows of an adjacency matrix are scanned by words, the set bits are the neighbours.
+template<class G, class Traits, bool in_edges>
+struct adjacency_iterable<G, Traits, in_edges, std::enable_if_t<
+      representation_v<G, Traits> == representation_t::adjacency_matrix &&
+      type_traits::is_bitset_v<typename adjacency_of<G, Traits, in_edges>::type>>> {
+  constexpr static bool ascending = true;
+
+  G& g;
+  node_t<G, Traits> start;
+
+  struct const_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<node_t<G, Traits>, adjacency_repr_t<G, Traits, in_edges>>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    using row_t = std::remove_pointer_t<decltype(adjacency_of<G, Traits, in_edges>::get(std::declval<G*>(),
+                                                                                         std::declval<node_t<G, Traits>>()))>;
+    iterator::bitset_iterator<row_t> it;
+
+    constexpr bool operator!=(const_iterator const& rhs) const {
+      return it != rhs.it;
+    }
+
+    constexpr const_iterator& operator++() {
+      ++it;
+      return *this;
+    }
+
+    constexpr value_type operator*() const noexcept {
+      if constexpr (in_edges) {
+        return {static_cast<node_t<G, Traits>>(it.index), nullptr};
+      } else {
+        return {static_cast<node_t<G, Traits>>(it.index), it};
+      }
+    }
+  };
+
+  constexpr const_iterator begin() const {
+    if (auto has_adj = adjacency_of<G, Traits, in_edges>::get(&g, start)) {
+      return {iterator::get_first_good(*has_adj)};
+    }
+    return {};
+  }
+
+  constexpr const_iterator end() const {
+    return {};
+  }
+
+  constexpr std::size_t size() const {
+    return std::distance(begin(), end());
+  }
+};
+
+template<class G, class Traits>
+struct edge_iterable<G, Traits, std::enable_if_t<has_node_container_v<G, Traits> && has_adjacency_container_v<G, Traits>>>
+      : adjacency_iterable<G, Traits, false> {
+};
+
 template<class G, class Traits, class Check, class Neigh>
 struct edge_list_iterable {
   G& g;
@@ -121,10 +272,10 @@ struct edge_list_iterable {
 
   struct const_iterator {
     using iterator_category = std::forward_iterator_tag;
-    using value_type = std::pair<node_t<G, Traits>, void* /*edge_repr_t<G, Traits> */>;
+    using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
     using difference_type = std::ptrdiff_t;
     using pointer = const value_type*;
-    using reference = const value_type&;
+    using reference = std::pair<detail::node_ref_t<G, Traits>, edge_repr_t<G, Traits>>;
 
     using wrapper_it = std::conditional_t<std::is_const_v<G>,
                                           bxlx::graph::type_traits::detail::std_begin_t<const edge_list_container_t<G, Traits>>,
@@ -149,11 +300,11 @@ struct edge_list_iterable {
       return *this;
     }
 
-    constexpr value_type operator*() const {
+    constexpr reference operator*() const {
       if constexpr (has_edge_container_v<G, Traits>) {
-        return {Neigh{}(it), /* get_edge(that->g, detail::edge_index_getter<G, Traits>{}(it))*/ nullptr};
+        return {Neigh{}(it), get_edge(that->g, detail::edge_index_getter<G, Traits>{}(it))};
       } else {
-        return {Neigh{}(it), /* it*/ nullptr};
+        return {Neigh{}(it), it};
       }
     }
   };
@@ -174,10 +325,73 @@ struct edge_list_iterable {
 };
 
 template<class G, class Traits>
-struct edge_iterable<G, Traits, std::enable_if_t<has_edge_list_container_v<G, Traits>>>
+struct edge_iterable<G, Traits, std::enable_if_t<has_edge_list_container_v<G, Traits> && !detail::has_ordered_sources_v<G, Traits>>>
       : edge_list_iterable<G, Traits, detail::source_getter<G, Traits>, detail::target_getter<G, Traits>> {
 };
 
+// The out edges are found with one lower_bound, the iteration stops at the first different source.
+template<class G, class Traits>
+struct edge_iterable<G, Traits, std::enable_if_t<detail::has_ordered_sources_v<G, Traits>>> {
+  // the edges of a source are ordered by the target when the edges are compared by operator<
+  constexpr static bool ascending = detail::has_less_compare_v<std::remove_cv_t<edge_list_container_t<G, Traits>>>;
+
+  G& g;
+  node_t<G, Traits> start;
+
+  struct const_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = std::pair<detail::node_ref_t<G, Traits>, edge_repr_t<G, Traits>>;
+
+    using wrapper_it = std::conditional_t<std::is_const_v<G>,
+                                          bxlx::graph::type_traits::detail::std_begin_t<const edge_list_container_t<G, Traits>>,
+                                          bxlx::graph::type_traits::detail::std_begin_t<edge_list_container_t<G, Traits>>>;
+    const edge_iterable* that;
+    wrapper_it it, end;
+
+    constexpr bool operator!=(const_iterator const& rhs) const {
+      return it != rhs.it;
+    }
+
+    constexpr const_iterator& operator++() {
+      if (++it != end && !(detail::source_getter<G, Traits>{}(it) == that->start))
+        it = end;
+      return *this;
+    }
+
+    constexpr reference operator*() const {
+      if constexpr (has_edge_container_v<G, Traits>) {
+        return {detail::target_getter<G, Traits>{}(it), get_edge(that->g, detail::edge_index_getter<G, Traits>{}(it))};
+      } else {
+        return {detail::target_getter<G, Traits>{}(it), it};
+      }
+    }
+  };
+
+  constexpr const_iterator begin() const {
+    using key_t = typename std::remove_cv_t<edge_list_container_t<G, Traits>>::key_type;
+    auto& el = detail::edge_list_container_getter<G, Traits>{}(g);
+    auto first = std::begin(el), it = el.lower_bound(detail::source_key<key_t>(
+          start, std::make_index_sequence<std::tuple_size_v<key_t> - 1>{})), end = std::end(el);
+    while (it != first && detail::source_getter<G, Traits>{}(std::prev(it)) == start)
+      --it;
+    if (it != end && !(detail::source_getter<G, Traits>{}(it) == start))
+      it = end;
+    return {this, it, end};
+  }
+
+  constexpr const_iterator end() const {
+    auto it = std::end(detail::edge_list_container_getter<G, Traits>{}(g));
+    return {this, it, it};
+  }
+
+  constexpr std::size_t size() const {
+    return std::distance(begin(), end());
+  }
+};
+
 
 template<class G, class Traits>
 struct in_edge_iterable<G, Traits, std::enable_if_t<has_edge_list_container_v<G, Traits>>>
@@ -186,63 +400,740 @@ struct in_edge_iterable<G, Traits, std::enable_if_t<has_edge_list_container_v<G,
 
 
 template<class G, class Traits>
-struct in_out_edge_iterable<G, Traits> {
+struct in_edge_iterable<G, Traits, std::enable_if_t<has_in_adjacency_container_v<G, Traits>>>
+      : adjacency_iterable<G, Traits, true> {
+};
+
+
+// Without in edge container the rows are filtered while iterating: every row is searched for the node, so nothing is
+// collected, but one full iteration visits every edge. For repeated queries the in_edge_index(g) groups all of the
+// edges by the target at once, and the in_degrees(g) counts every in degree with one pass.
+template<class G, class Traits>
+struct in_edge_iterable<G, Traits, std::enable_if_t<has_adjacency_container_v<G, Traits> &&
+                                                    !has_in_adjacency_container_v<G, Traits> &&
+                                                    !detail::has_bitset_rows_v<G, Traits>>> {
+  // the sources come in node order
+  constexpr static bool ascending = [] {
+    if constexpr (is_user_defined_node_type_v<G, Traits>)
+      return detail::has_less_compare_v<std::remove_cv_t<node_container_t<G, Traits>>>;
+    else
+      return true;
+  }();
+
   G& g;
-  node_t<G, Traits> node;
+  node_t<G, Traits> start;
 
   struct const_iterator {
     using iterator_category = std::forward_iterator_tag;
-    using value_type = std::pair<node_t<G, Traits>, void* /*edge_repr_t<G, Traits> */>;
+    using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
     using difference_type = std::ptrdiff_t;
     using pointer = const value_type*;
-    using reference = const value_type&;
+    using reference = std::pair<detail::node_ref_t<G, Traits>, edge_repr_t<G, Traits>>;
+
+    using node_it = decltype(std::declval<node_iterable<G, Traits> const&>().begin());
+    using row_it = typename edge_iterable<G, Traits>::const_iterator;
 
     G* g;
-    node_t<G, Traits> node;
-    decltype(std::begin(node_indices(std::declval<const G&>()))) end, curr;
-
-    constexpr const_iterator(
-          G& g,
-          node_t<G, Traits> node,
-          bool end
-          ) : g(&g), node(node),
-          end(std::end(node_indices(g))),
-          curr(end ? this->end : std::begin(node_indices(g)))
-    {
-      if (curr != this->end && !(has_edge(g, node, *curr) || has_edge(g, *curr, node)))
-        ++*this;
+    node_t<G, Traits> start;
+    node_it node, last;
+    row_it it{}, row_end{};
+
+    constexpr bool operator!=(const_iterator const& rhs) const {
+      return node != rhs.node || (node != last && it != rhs.it);
+    }
+
+    constexpr const_iterator& operator++() {
+      ++it;
+      return skip();
+    }
+
+    constexpr reference operator*() const {
+      return {*node, (*it).second};
+    }
+
+    constexpr void open_row() {
+      const edge_iterable<G, Traits> row{*g, *node};
+      it = row.begin();
+      row_end = row.end();
+    }
+
+    constexpr const_iterator& skip() {
+      while (node != last) {
+        for (; it != row_end; ++it)
+          if ((*it).first == start)
+            return *this;
+        if (++node != last)
+          open_row();
+      }
+      return *this;
     }
+  };
+
+  constexpr const_iterator begin() const {
+    const node_iterable<G, Traits> nodes{g};
+    const_iterator res{&g, start, nodes.begin(), nodes.end()};
+    if (res.node != res.last)
+      res.open_row();
+    return res.skip();
+  }
+
+  constexpr const_iterator end() const {
+    const node_iterable<G, Traits> nodes{g};
+    return {&g, start, nodes.end(), nodes.end()};
+  }
+
+  constexpr std::size_t size() const {
+    return std::distance(begin(), end());
+  }
+};
+
+
+// In edges of a bitset adjacency matrix: the column of the node is tested row by row while iterating, so nothing is
+// collected. For repeated queries the in_edge_index(g) transposes the whole matrix.
+template<class G, class Traits>
+struct in_edge_iterable<G, Traits, std::enable_if_t<detail::has_bitset_rows_v<G, Traits>>> {
+  constexpr static bool ascending = true;
+
+  G& g;
+  node_t<G, Traits> start;
+
+  struct const_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    G* g;
+    std::size_t to;
+    std::size_t from;
+    detail::compressed_matrix m{};
+    edge_repr_t<G, Traits> repr{};
 
     constexpr bool operator!=(const_iterator const& rhs) const {
-      return curr != rhs.curr;
+      return from != rhs.from;
     }
 
     constexpr const_iterator& operator++() {
-      while (++curr != end) {
-        if (has_edge(*g, node, *curr) || has_edge(*g, *curr, node))
-          break;
+      ++from;
+      return skip();
+    }
+
+    constexpr value_type operator*() const noexcept {
+      return {static_cast<node_t<G, Traits>>(from), repr};
+    }
+
+    constexpr const_iterator& skip() {
+      if constexpr (has_node_container_v<G, Traits>) {
+        for (const std::size_t n = node_count(*g); from < n; ++from) {
+          if (auto* row = adjacents(g, static_cast<node_t<G, Traits>>(from)); row && to < std::size(*row) && (*row)[to]) {
+            repr = {row, to, std::size(*row)};
+            return *this;
+          }
+        }
+      } else {
+        auto&& bits = detail::adjacent_container_getter<G, Traits>{}(*g);
+        for (; from < m.k; ++from) {
+          if (const std::size_t ix = m.index(from, to); ix < std::size(bits) && bits[ix]) {
+            repr = {&bits, ix, std::size(bits)};
+            return *this;
+          }
+        }
       }
       return *this;
     }
+  };
 
-    constexpr value_type operator*() const {
-      if constexpr (has_edge_container_v<G, Traits>) {
-        return {*curr, /* get_edge(that->g, detail::edge_index_getter<G, Traits>{}(it))*/ nullptr};
+  constexpr const_iterator begin() const {
+    const_iterator res{&g, static_cast<std::size_t>(start), 0};
+    if constexpr (!has_node_container_v<G, Traits>)
+      res.m = detail::compressed_matrix_of<G, Traits>(std::size(detail::adjacent_container_getter<G, Traits>{}(g)));
+    return res.skip();
+  }
+
+  constexpr const_iterator end() const {
+    return {&g, static_cast<std::size_t>(start), node_count(g)};
+  }
+
+  constexpr std::size_t size() const {
+    return std::distance(begin(), end());
+  }
+};
+
+// Edge list iterators grouped by the source (or the target) node.
+// Built once with one sort, after that the edges of a node are found with a binary search and iterated without
+// touching any other edge. The grouping is stable, so the edges are visited in the edge list order.
+template<class G, class Traits, bool in_edges>
+struct edge_list_index {
+  using Check = std::conditional_t<in_edges, detail::target_getter<G, Traits>, detail::source_getter<G, Traits>>;
+  using Neigh = std::conditional_t<in_edges, detail::source_getter<G, Traits>, detail::target_getter<G, Traits>>;
+  using wrapper_it = std::conditional_t<std::is_const_v<G>,
+                                        bxlx::graph::type_traits::detail::std_begin_t<const edge_list_container_t<G, Traits>>,
+                                        bxlx::graph::type_traits::detail::std_begin_t<edge_list_container_t<G, Traits>>>;
+
+  G* g;
+  std::vector<wrapper_it> grouped;
+
+  constexpr explicit edge_list_index(G& g) : g(&g) {
+    auto&& el = detail::edge_list_container_getter<G, Traits>{}(g);
+    grouped.reserve(static_cast<std::size_t>(std::distance(std::begin(el), std::end(el))));
+    for (auto it = std::begin(el), end = std::end(el); it != end; ++it)
+      grouped.push_back(it);
+    std::stable_sort(grouped.begin(), grouped.end(), [] (wrapper_it const& l, wrapper_it const& r) {
+      return Check{}(l) < Check{}(r);
+    });
+  }
+
+  struct iterable {
+    G* g;
+    const wrapper_it* first;
+    const wrapper_it* last;
+
+    struct const_iterator {
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const value_type*;
+      using reference = std::pair<detail::node_ref_t<G, Traits>, edge_repr_t<G, Traits>>;
+
+      G* g;
+      const wrapper_it* it;
+
+      constexpr bool operator!=(const_iterator const& rhs) const {
+        return it != rhs.it;
+      }
+
+      constexpr const_iterator& operator++() {
+        ++it;
+        return *this;
+      }
+
+      constexpr reference operator*() const {
+        if constexpr (has_edge_container_v<G, Traits>) {
+          return {Neigh{}(*it), get_edge(*g, detail::edge_index_getter<G, Traits>{}(*it))};
+        } else {
+          return {Neigh{}(*it), *it};
+        }
+      }
+    };
+
+    constexpr const_iterator begin() const {
+      return {g, first};
+    }
+
+    constexpr const_iterator end() const {
+      return {g, last};
+    }
+
+    constexpr std::size_t size() const {
+      return static_cast<std::size_t>(last - first);
+    }
+  };
+
+  constexpr iterable operator()(node_t<G, Traits> const& node) const {
+    struct cmp_t {
+      constexpr bool operator()(wrapper_it const& it, node_t<G, Traits> const& n) const {
+        return Check{}(it) < n;
+      }
+      constexpr bool operator()(node_t<G, Traits> const& n, wrapper_it const& it) const {
+        return n < Check{}(it);
+      }
+    };
+    auto [from, to] = std::equal_range(grouped.data(), grouped.data() + grouped.size(), node, cmp_t{});
+    return {g, from, to};
+  }
+};
+
+
+// Transposed compressed sparse row index of an adjacency list or matrix with numeric nodes.
+// The node_count + 1 offsets and the (source, edge repr) entries grouped by their target are filled by a counting sort,
+// which walks the out edges twice: once for the in-degrees and once to place the entries. The in edges of a node are
+// then iterated in O(in-degree).
+template<class G, class Traits>
+struct transposed_index {
+  using entry_t = std::pair<std::size_t, edge_repr_t<G, Traits>>;
+
+  std::size_t n;
+  std::vector<std::size_t> offsets;
+  std::vector<entry_t> entries;
+
+  constexpr explicit transposed_index(G& g) : n(node_count(g)), offsets(n + 1) {
+    for (node_t<G, Traits> from : node_indices<G, Traits, true>(g))
+      for (auto [to, repr] : out_edges<G, Traits>(g, from))
+        ++offsets[static_cast<std::size_t>(to) + 1];
+
+    for (std::size_t i = 1; i <= n; ++i)
+      offsets[i] += offsets[i-1];
+
+    entries.resize(offsets[n]);
+    for (node_t<G, Traits> from : node_indices<G, Traits, true>(g))
+      for (auto [to, repr] : out_edges<G, Traits>(g, from))
+        entries[offsets[static_cast<std::size_t>(to)]++] = {static_cast<std::size_t>(from), repr};
+
+    for (std::size_t i = n; i > 0; --i)
+      offsets[i] = offsets[i-1];
+    offsets[0] = 0;
+  }
+
+  struct iterable {
+    constexpr static bool ascending = true;
+
+    const entry_t* first;
+    const entry_t* last;
+
+    struct const_iterator {
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const value_type*;
+      using reference = const value_type&;
+
+      const entry_t* it;
+
+      constexpr bool operator!=(const_iterator const& rhs) const {
+        return it != rhs.it;
+      }
+
+      constexpr const_iterator& operator++() {
+        ++it;
+        return *this;
+      }
+
+      constexpr value_type operator*() const {
+        return {static_cast<node_t<G, Traits>>(it->first), it->second};
+      }
+    };
+
+    constexpr const_iterator begin() const {
+      return {first};
+    }
+
+    constexpr const_iterator end() const {
+      return {last};
+    }
+
+    constexpr std::size_t size() const {
+      return static_cast<std::size_t>(last - first);
+    }
+  };
+
+  constexpr iterable operator()(node_t<G, Traits> const& node) const {
+    if (static_cast<std::size_t>(node) >= n)
+      return {entries.data(), entries.data()};
+    return {entries.data() + offsets[static_cast<std::size_t>(node)],
+            entries.data() + offsets[static_cast<std::size_t>(node) + 1]};
+  }
+};
+
+
+// Transposed copy of a bitset adjacency matrix, one packed row of 64 bit words per node.
+// Square matrices are read in 64x64 bit blocks which are transposed in registers (detail::transpose_block), the empty
+// blocks are skipped; the matrices without diagonal are scattered from the out edges. The in edges of a node are then
+// scanned word by word like an out edge row.
+template<class G, class Traits>
+struct transposed_matrix {
+  G* g;
+  std::size_t n;
+  std::size_t row_words;
+  std::vector<std::uint64_t> words;
+  // the shape of a compressed matrix, the edge reprs point into the original bitset
+  detail::compressed_matrix m{};
+
+  explicit transposed_matrix(G& g) : g(&g), n(node_count(g)), row_words((n + 63) / 64), words(n * row_words) {
+    if constexpr (has_node_container_v<G, Traits>) {
+      transpose([&g] (std::size_t row, std::size_t column, std::size_t last) -> std::uint64_t {
+        if (auto* adj = adjacents(&g, static_cast<node_t<G, Traits>>(row)))
+          return detail::read_bits(*adj, std::min(column, std::size(*adj)), std::min(last, std::size(*adj)));
+        return 0;
+      });
+    } else if (auto&& bits = detail::adjacent_container_getter<G, Traits>{}(g);
+               (m = detail::compressed_matrix_of<G, Traits>(std::size(bits))).layout == detail::compressed_layout::square) {
+      transpose([&bits, n = n] (std::size_t row, std::size_t column, std::size_t last) -> std::uint64_t {
+        return detail::read_bits(bits, row * n + column, row * n + last);
+      });
+    } else {
+      for (std::size_t from{}; from < n; ++from)
+        for (auto [to, repr] : out_edges(g, static_cast<node_t<G, Traits>>(from)))
+          words[static_cast<std::size_t>(to) * row_words + from / 64] |= std::uint64_t{1} << from % 64;
+    }
+  }
+
+  // row_bits(row, column, last) reads the [column, last) bits of the row
+  template<class RowBits>
+  void transpose(RowBits&& row_bits) {
+    std::uint64_t block[64];
+    for (std::size_t row{}; row < n; row += 64) {
+      for (std::size_t column{}; column < n; column += 64) {
+        std::uint64_t any{};
+        for (std::size_t i{}; i < 64; ++i)
+          any |= block[i] = row + i < n ? row_bits(row + i, column, std::min(n, column + 64)) : 0;
+        if (!any)
+          continue;
+
+        detail::transpose_block(block);
+        for (std::size_t i{}; i < 64 && column + i < n; ++i)
+          words[(column + i) * row_words + row / 64] = block[i];
+      }
+    }
+  }
+
+  // the (from, to) edge of the original matrix
+  constexpr static edge_repr_t<G, Traits> repr_of(G* g, detail::compressed_matrix const& m, std::size_t from, std::size_t to) {
+    if constexpr (has_node_container_v<G, Traits>) {
+      auto* row = adjacents(g, static_cast<node_t<G, Traits>>(from));
+      return {row, to, std::size(*row)};
+    } else {
+      auto&& bits = detail::adjacent_container_getter<G, Traits>{}(*g);
+      return {&bits, m.index(from, to), std::size(bits)};
+    }
+  }
+
+  struct iterable {
+    constexpr static bool ascending = true;
+
+    G* g;
+    detail::compressed_matrix m;
+    std::size_t to;
+    const std::uint64_t* row;
+    std::size_t n;
+
+    struct const_iterator {
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const value_type*;
+      using reference = const value_type&;
+
+      G* g;
+      detail::compressed_matrix m;
+      std::size_t to;
+      const std::uint64_t* row;
+      std::size_t index;
+      std::size_t n;
+
+      constexpr bool operator!=(const_iterator const& rhs) const {
+        return index != rhs.index;
+      }
+
+      constexpr const_iterator& operator++() {
+        index = detail::find_next_set_word(row, index + 1, n);
+        return *this;
+      }
+
+      constexpr value_type operator*() const {
+        return {static_cast<node_t<G, Traits>>(index), repr_of(g, m, index, to)};
+      }
+    };
+
+    constexpr const_iterator begin() const {
+      return {g, m, to, row, row ? detail::find_next_set_word(row, 0, n) : n, n};
+    }
+
+    constexpr const_iterator end() const {
+      return {g, m, to, row, n, n};
+    }
+
+    constexpr std::size_t size() const {
+      return row ? detail::count_set_word(row, 0, n) : 0;
+    }
+  };
+
+  constexpr iterable operator()(node_t<G, Traits> const& node) const {
+    if (static_cast<std::size_t>(node) >= n)
+      return {g, m, 0, nullptr, 0};
+    return {g, m, static_cast<std::size_t>(node), words.data() + static_cast<std::size_t>(node) * row_words, n};
+  }
+};
+
+
+// Occupancy bitmap next to an adjacency matrix of optional or multi edge cells, one packed row of 64 bit words per
+// node. The present cells of a row are found with countr_zero, so a sparse row is iterated without reading its empty
+// cells, and the edges are counted with popcount. The bitmap is a snapshot: after the matrix is changed, the modified
+// cells must be passed to update().
+template<class G, class Traits>
+struct occupancy_bitmap {
+  G* g;
+  std::size_t n;
+  std::size_t row_words;
+  std::vector<std::uint64_t> words;
+
+  explicit occupancy_bitmap(G& g) : g(&g), n(node_count(g)), row_words((n + 63) / 64), words(n * row_words) {
+    for (std::size_t from{}; from < n; ++from) {
+      if (auto* adj = adjacents(&g, static_cast<node_t<G, Traits>>(from))) {
+        std::size_t to{};
+        for (auto&& cell : *adj) {
+          if (to >= n)
+            break;
+          if (detail::cell_present(cell))
+            words[from * row_words + to / 64] |= std::uint64_t{1} << to % 64;
+          ++to;
+        }
+      }
+    }
+  }
+
+  // rereads the (from, to) cell of the matrix
+  constexpr void update(node_t<G, Traits> const& from, node_t<G, Traits> const& to) {
+    const auto f = static_cast<std::size_t>(from), t = static_cast<std::size_t>(to);
+    if (f >= n || t >= n)
+      return;
+    std::uint64_t& word = words[f * row_words + t / 64];
+    word &= ~(std::uint64_t{1} << t % 64);
+    if (auto* adj = adjacents(g, from); adj && t < std::size(*adj) && detail::cell_present(std::begin(*adj)[t]))
+      word |= std::uint64_t{1} << t % 64;
+  }
+
+  constexpr std::size_t edge_count() const {
+    return detail::count_set_word(words.data(), 0, words.size() * 64);
+  }
+
+  struct iterable {
+    constexpr static bool ascending = true;
+
+    G* g;
+    const std::uint64_t* row;
+    std::size_t n;
+    node_t<G, Traits> from;
+
+    struct const_iterator {
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const value_type*;
+      using reference = const value_type&;
+
+      const std::uint64_t* row;
+      std::size_t index;
+      std::size_t n;
+      edge_repr_t<G, Traits> first;
+
+      constexpr bool operator!=(const_iterator const& rhs) const {
+        return index != rhs.index;
+      }
+
+      constexpr const_iterator& operator++() {
+        index = detail::find_next_set_word(row, index + 1, n);
+        return *this;
+      }
+
+      constexpr value_type operator*() const {
+        return {static_cast<node_t<G, Traits>>(index), std::next(first, static_cast<std::ptrdiff_t>(index))};
+      }
+    };
+
+    constexpr const_iterator begin() const {
+      if (!row)
+        return {row, n, n, {}};
+      return {row, detail::find_next_set_word(row, 0, n), n, std::begin(*adjacents(g, from))};
+    }
+
+    constexpr const_iterator end() const {
+      return {row, n, n, {}};
+    }
+
+    constexpr std::size_t size() const {
+      return row ? detail::count_set_word(row, 0, n) : 0;
+    }
+  };
+
+  constexpr iterable operator()(node_t<G, Traits> const& node) const {
+    if (static_cast<std::size_t>(node) >= n || !adjacents(g, node))
+      return {g, nullptr, 0, node};
+    return {g, words.data() + static_cast<std::size_t>(node) * row_words, n, node};
+  }
+};
+
+
+// Neighbours in both direction of two ascending edge streams, merged while iterating: every node is listed once, with
+// its out edge if there is one. Nothing is collected, one step advances the streams past the current node.
+template<class G, class Traits, class Out, class In>
+struct merged_edge_iterable {
+  G* g;
+  node_t<G, Traits> node;
+  Out out;
+  In in;
+
+  struct const_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = std::pair<detail::node_ref_t<G, Traits>, edge_repr_t<G, Traits>>;
+
+    using out_it = decltype(std::declval<Out const&>().begin());
+    using in_it = decltype(std::declval<In const&>().begin());
+
+    G* g;
+    const node_t<G, Traits>* node;
+    out_it o, o_end;
+    in_it i, i_end;
+
+    // the out edge is taken when both streams are at the same node
+    constexpr bool from_out() const {
+      return o != o_end && (!(i != i_end) || !((*i).first < (*o).first));
+    }
+
+    constexpr bool operator!=(const_iterator const& rhs) const {
+      return o != rhs.o || i != rhs.i;
+    }
+
+    constexpr const_iterator& operator++() {
+      const auto current = from_out() ? detail::to_handle<G, Traits>((*o).first) : detail::to_handle<G, Traits>((*i).first);
+      while (o != o_end && (*o).first == detail::from_handle<G, Traits>(current))
+        ++o;
+      while (i != i_end && (*i).first == detail::from_handle<G, Traits>(current))
+        ++i;
+      return *this;
+    }
+
+    // the in adjacency rows have no repr without edge container, those edges are looked up from the source
+    constexpr reference operator*() const {
+      if (from_out()) {
+        auto&& [to, repr] = *o;
+        return {to, repr};
+      }
+      auto&& [from, repr] = *i;
+      if constexpr (std::is_same_v<std::decay_t<decltype(repr)>, void*>) {
+        return {from, get_edge<G, Traits>(*g, from, *node)};
       } else {
-        return {*curr, /* it*/ nullptr};
+        return {from, repr};
       }
     }
   };
 
   constexpr const_iterator begin() const {
-    return {g, node, false};
+    return {g, &node, out.begin(), out.end(), in.begin(), in.end()};
   }
 
   constexpr const_iterator end() const {
-    return {g, node, true};
+    return {g, &node, out.end(), out.end(), in.end(), in.end()};
+  }
+
+  constexpr std::size_t size() const {
+    return std::distance(begin(), end());
   }
 };
 
+// Neighbours in both direction of edge streams which are not ascending: they are collected after the end of a buffer,
+// sorted and deduplicated. A traversal passes one buffer to every step, the neighbours of the nested steps are stacked
+// at its end and removed with their iterable, so the buffer is allocated only while it grows.
+template<class G, class Traits>
+struct buffered_edge_iterable {
+  using entry_t = std::pair<detail::node_handle_t<G, Traits>, edge_repr_t<G, Traits>>;
+
+  std::vector<entry_t> own;
+  std::vector<entry_t>* shared;
+  std::size_t first;
+  std::size_t last;
+
+  template<class Out, class In>
+  buffered_edge_iterable(G& g, node_t<G, Traits> const& node, Out&& out, In&& in, std::vector<entry_t>* shared = nullptr)
+        : shared(shared), first(shared ? shared->size() : 0) {
+    last = collect(g, node, out, in, shared ? *shared : own);
+  }
+
+  ~buffered_edge_iterable() {
+    if (shared)
+      shared->erase(shared->begin() + static_cast<std::ptrdiff_t>(first), shared->end());
+  }
+
+  // The repr of a neighbour is its out edge if there is one, otherwise its in edge. The in adjacency rows have no
+  // repr without edge container, those edges are looked up from the source.
+  template<class Out, class In>
+  static std::size_t collect(G& g, node_t<G, Traits> const& node, Out& out, In& in, std::vector<entry_t>& res) {
+    constexpr auto get = [] (entry_t const& e) -> detail::node_ref_t<G, Traits> {
+      return detail::from_handle<G, Traits>(e.first);
+    };
+
+    const auto first = static_cast<std::ptrdiff_t>(res.size());
+    for (auto [to, repr] : out)
+      res.emplace_back(detail::to_handle<G, Traits>(to), repr);
+    for (auto [from, repr] : in) {
+      if constexpr (std::is_same_v<decltype(repr), void*>) {
+        res.emplace_back(detail::to_handle<G, Traits>(from), get_edge<G, Traits>(g, from, node));
+      } else {
+        res.emplace_back(detail::to_handle<G, Traits>(from), repr);
+      }
+    }
+
+    const auto begin = res.begin() + first;
+    if constexpr (detail::is_less_comparable_v<node_t<G, Traits>>) {
+      std::stable_sort(begin, res.end(), [get] (entry_t const& l, entry_t const& r) {
+        return get(l) < get(r);
+      });
+      res.erase(std::unique(begin, res.end(), [get] (entry_t const& l, entry_t const& r) {
+        return get(l) == get(r);
+      }), res.end());
+    } else {
+      auto last = begin;
+      for (auto it = begin; it != res.end(); ++it)
+        if (std::find_if(begin, last, [get, &it] (entry_t const& e) { return get(e) == get(*it); }) == last)
+          *last++ = *it;
+      res.erase(last, res.end());
+    }
+    return res.size();
+  }
+
+  struct const_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<node_t<G, Traits>, edge_repr_t<G, Traits>>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = std::pair<detail::node_ref_t<G, Traits>, edge_repr_t<G, Traits>>;
+
+    // an index, the nested steps can reallocate the shared buffer
+    const std::vector<entry_t>* entries;
+    std::size_t ix;
+
+    constexpr bool operator!=(const_iterator const& rhs) const {
+      return ix != rhs.ix;
+    }
+
+    constexpr const_iterator& operator++() {
+      ++ix;
+      return *this;
+    }
+
+    constexpr reference operator*() const {
+      auto const& [handle, repr] = (*entries)[ix];
+      return {detail::from_handle<G, Traits>(handle), repr};
+    }
+  };
+
+  const_iterator begin() const {
+    return {shared ? shared : &own, first};
+  }
+
+  const_iterator end() const {
+    return {shared ? shared : &own, last};
+  }
+
+  constexpr std::size_t size() const {
+    return last - first;
+  }
+};
+
+template<class G, class Traits>
+constexpr bool has_ascending_in_out_v = detail::is_less_comparable_v<node_t<G, Traits>> &&
+                                        detail::is_ascending_v<edge_iterable<G, Traits>> &&
+                                        detail::is_ascending_v<in_edge_iterable<G, Traits>>;
+
+// Neighbours in both direction: the out and the in edge stream merged, every node listed once.
+template<class G, class Traits>
+struct in_out_edge_iterable<G, Traits, std::enable_if_t<has_ascending_in_out_v<G, Traits>>>
+      : merged_edge_iterable<G, Traits, edge_iterable<G, Traits>, in_edge_iterable<G, Traits>> {
+  constexpr in_out_edge_iterable(G& g, node_t<G, Traits> const& node)
+        : merged_edge_iterable<G, Traits, edge_iterable<G, Traits>, in_edge_iterable<G, Traits>>{
+                &g, node, out_edges<G, Traits>(g, node), in_edges<G, Traits>(g, node)} {}
+};
+
+template<class G, class Traits>
+struct in_out_edge_iterable<G, Traits, std::enable_if_t<!has_ascending_in_out_v<G, Traits>>>
+      : buffered_edge_iterable<G, Traits> {
+  in_out_edge_iterable(G& g, node_t<G, Traits> const& node)
+        : buffered_edge_iterable<G, Traits>(g, node, out_edges<G, Traits>(g, node), in_edges<G, Traits>(g, node)) {}
+};
+
 }
 
 #endif //BXLX_GRAPH_EDGE_ITERATOR_HPP
@@ -18,8 +18,8 @@ template <std::size_t I>
 struct tuple_getter_t {
   template <class T, class... Ts>
   [[nodiscard]] constexpr inline auto
-  operator()(T&& val, Ts&&...) const noexcept -> copy_cvref_t<T&&, std::tuple_element_t<I, T>> {
-    return std::get<I>(val);
+  operator()(T&& val, Ts&&...) const noexcept -> copy_cvref_t<T&&, std::tuple_element_t<I, std::remove_reference_t<T>>> {
+    return std::get<I>(std::forward<T>(val));
   }
 };
 
@@ -43,7 +43,7 @@ struct last_getter_t {
     } else if constexpr (std::tuple_size_v<std::remove_reference_t<T>> > I) {
       return last_getter_t<>{}(std::get<std::tuple_size_v<std::remove_reference_t<T>> - I>(std::forward<T&&>(val)));
     } else {
-      return last_getter_t<I + 1 - std::tuple_size_v<T>>{}(std::get<0>(std::forward<T&&>(val)));
+      return last_getter_t<I + 1 - std::tuple_size_v<std::remove_reference_t<T>>>{}(std::get<0>(std::forward<T&&>(val)));
     }
   }
 };
@@ -58,6 +58,18 @@ struct indirect_t {
   }
 };
 
+// the value of an optional matrix cell, any other value is passed through
+struct deref_optional_t {
+  template <class T, class... Ts>
+  [[nodiscard]] constexpr inline decltype(auto) operator()(T&& val, Ts&&...) const noexcept {
+    if constexpr (type_traits::is_optional_v<std::remove_reference_t<T>>) {
+      return *std::forward<T>(val);
+    } else {
+      return std::forward<T>(val);
+    }
+  }
+};
+
 struct identity_t {
   template <class T, class... Ts>
   [[nodiscard]] constexpr inline T&& operator()(T&& val, Ts&&...) const noexcept {
@@ -93,13 +105,24 @@ using edge_list_container_getter = std::conditional_t<
                          first_getter_t>,
       noop_t>;
 
+// the key of a map like node container is the node itself, the rest is in the mapped value
+template <class G, class Traits, class = void>
+constexpr bool has_keyed_node_container_v = false;
+template <class G, class Traits>
+constexpr bool has_keyed_node_container_v<G, Traits, std::enable_if_t<has_node_container_v<G, Traits>>> =
+      type_traits::range_type_v<std::remove_cv_t<node_container_t<G, Traits>>> == type_traits::range_type_t::map_like;
+
+template <class G, class Traits>
+using node_value_getter = std::conditional_t<has_keyed_node_container_v<G, Traits>,
+                                             composition_t<tuple_getter_t<1>, indirect_t>, indirect_t>;
+
 template <class G, class Traits>
 using adjacent_container_getter =
       std::conditional_t<has_adjacency_container_v<G, Traits>,
                          std::conditional_t<has_node_container_v<G, Traits>,
                                             composition_t<std::conditional_t<has_in_edges_v<G, Traits>,
                                                                              last_getter_t<1 + has_node_property_v<G, Traits>>,
-                                                                             first_getter_t>, indirect_t>,
+                                                                             first_getter_t>, node_value_getter<G, Traits>>,
                                             first_getter_t>,
                          noop_t>;
 
@@ -111,7 +134,11 @@ template <class G, class Traits>
 using node_property_getter = std::conditional_t<has_node_property_v<G, Traits>, composition_t<last_getter_t<>, indirect_t>, noop_t>;
 
 template <class G, class Traits>
-using edge_property_getter = std::conditional_t<has_edge_property_v<G, Traits>, composition_t<last_getter_t<>, indirect_t>, noop_t>;
+using edge_property_getter = std::conditional_t<has_edge_property_v<G, Traits>,
+                                                std::conditional_t<representation_v<G, Traits> == representation_t::adjacency_matrix,
+                                                                   composition_t<last_getter_t<>, composition_t<deref_optional_t, indirect_t>>,
+                                                                   composition_t<last_getter_t<>, indirect_t>>,
+                                                noop_t>;
 
 template <class G, class Traits>
 using edge_index_getter = std::conditional_t<has_edge_container_v<G, Traits>, composition_t<last_getter_t<>, indirect_t>, noop_t>;
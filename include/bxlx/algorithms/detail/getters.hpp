@@ -12,10 +12,13 @@
 #include "bxlx/algorithms/constants.hpp"
 #include "edge_iterator.hpp"
 #include "getter_types.hpp"
+#include "linear_search.hpp"
 #include "node_iterator.hpp"
 #include "node_set.hpp"
+#include <algorithm>
 #include <climits>
 #include <set>
+#include <vector>
 
 namespace bxlx::graph {
 
@@ -35,28 +38,38 @@ constexpr auto edge_list(G&& graph) -> detail::copy_cvref_t<G&&, edge_list_conta
 }
 
 namespace detail {
-  template <class G, class Traits, class getter>
-  constexpr decltype(auto) get_node_properties(G&& graph, node_t<G, Traits> const& node) {
+  // the index nodes can be signed, a negative node is never in the container
+  template <class Key>
+  constexpr bool is_index_in_range(Key const& node, std::size_t size) {
+    if constexpr (std::is_signed_v<Key>) {
+      if (node < 0)
+        return false;
+    }
+    return static_cast<std::size_t>(node) < size;
+  }
+
+  template <class G, class Traits, class getter, class Key>
+  constexpr decltype(auto) get_node_properties(G&& graph, Key const& node) {
     auto&& node_cont = nodes(std::forward<G&&>(graph));
     if constexpr (is_user_defined_node_type_v<G, Traits>) {
       if (auto [from, to] = node_cont.equal_range(node); from != to)
         return getter{}(from);
     } else {
-      if (std::size(node_cont) > node) {
+      if (is_index_in_range(node, std::size(node_cont))) {
         return getter{}(std::next(std::begin(node_cont), node));
       }
     }
     detail::throw_or_terminate<std::out_of_range>("Cannot find node");
   }
 
-  template <class G, class Traits, class getter, class Res>
-  constexpr auto get_node_properties_ptr(G* graph, node_t<G, Traits> const& node) -> Res {
+  template <class G, class Traits, class getter, class Res, class Key>
+  constexpr auto get_node_properties_ptr(G* graph, Key const& node) -> Res {
     auto&& node_cont = nodes(*graph);
     if constexpr (is_user_defined_node_type_v<G, Traits>) {
       if (auto [from, to] = node_cont.equal_range(node); from != to)
         return std::addressof(getter{}(from));
     } else {
-      if (std::size(node_cont) > node)
+      if (is_index_in_range(node, std::size(node_cont)))
         return std::addressof(getter{}(std::next(std::begin(node_cont), node)));
     }
     return {};
@@ -77,6 +90,22 @@ constexpr auto adjacents(G* graph, node_t<G, Traits> const& node)
                                          detail::copy_cvref_t<G, adjacency_container_t<G, Traits>>*>(graph, node);
 }
 
+template <class G, class Key, class Traits>
+constexpr auto adjacents(G&& graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>,
+                          detail::copy_cvref_t<G&&, adjacency_container_t<G, Traits, true>>> {
+  return detail::get_node_properties<G, Traits, detail::adjacent_container_getter<G, Traits>>(std::forward<G>(graph),
+                                                                                              node);
+}
+
+template <class G, class Key, class Traits>
+constexpr auto adjacents(G* graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>,
+                          detail::copy_cvref_t<G, adjacency_container_t<G, Traits, true>>*> {
+  return detail::get_node_properties_ptr<G, Traits, detail::adjacent_container_getter<G, Traits>,
+                                         detail::copy_cvref_t<G, adjacency_container_t<G, Traits>>*>(graph, node);
+}
+
 template <class G, class Traits>
 constexpr auto in_adjacents(G&& graph, node_t<G, Traits, true> const& node)
       -> detail::copy_cvref_t<G&&, in_adjacency_container_t<G, Traits>> {
@@ -122,12 +151,9 @@ constexpr auto node_count(G const& graph)
   if constexpr (has_node_container_v<G, Traits>) {
     return std::size(detail::node_container_getter<G, Traits>{}(graph));
   } else {
-    if (auto size = std::size(detail::adjacent_container_getter<G, Traits>{}(graph)); detail::is_square_num(size)) {
-      return detail::constexpr_sqrt(size);
-    } else if (detail::is_k_x_km1(size)) {
-      return detail::constexpr_sqrt_no_self(size);
-    } else if (detail::is_k_x_km1_d_2(size)) {
-      return detail::constexpr_sqrt_no_self(size * 2) + 1;
+    if (const auto m = detail::compressed_matrix_of<G, Traits>(std::size(detail::adjacent_container_getter<G, Traits>{}(graph)));
+        m.layout != detail::compressed_layout::invalid) {
+      return m.k;
     } else {
       throw;
     }
@@ -140,66 +166,314 @@ constexpr auto node_count(G const& graph, Cmp&& cmp)
   return std::size(node_indices(graph, std::forward<Cmp>(cmp)));
 }
 
-template <class G, class Traits>
-constexpr auto get_edge(G& graph, node_t<G, Traits> const& from, node_t<G, Traits> const& to)
-      -> edge_repr_t<G, Traits> {
-  if constexpr (has_adjacency_container_v<G, Traits>) {
-    if constexpr (has_node_container_v<G, Traits>) {
-      if (auto* adj = adjacents(&graph, from)) {
-        if constexpr (detail::is_associative<node_container_t, G, Traits>) {
-          if (auto [f, t] = adj->equal_range(to); f != t) {
+namespace detail {
+  template<class G, class Traits, class = void>
+  constexpr bool has_sortable_adjacency_v = false;
+  template<class G, class Traits>
+  constexpr bool has_sortable_adjacency_v<G, Traits, std::enable_if_t<
+        has_node_container_v<G, Traits> && representation_v<G, Traits> == representation_t::adjacency_list>> =
+        !is_associative<adjacency_container_t, G, Traits> && is_less_comparable_v<node_t<G, Traits>> &&
+        std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<
+              type_traits::detail::std_begin_t<const adjacency_container_t<G, Traits>>>::iterator_category>;
+
+  // lower bound in a sorted row, the loop has no data dependent branch
+  template<class G, class Traits, class It, class Node>
+  constexpr It lower_bound_adjacent(It first, It last, Node const& to) {
+    using projection = composition_t<first_getter_t, indirect_t>;
+    auto len = last - first;
+    if (len == 0)
+      return last;
+    while (len > 1) {
+      const auto half = len / 2;
+      first = projection{}(first + half) < to ? first + half : first;
+      len -= half;
+    }
+    return projection{}(first) < to ? first + 1 : first;
+  }
+
+  template<class G, class Traits, class Row, class Node>
+  constexpr auto find_adjacent(Row& row, Node const& to, [[maybe_unused]] bool sorted) {
+    using projection = composition_t<first_getter_t, indirect_t>;
+    auto it = std::begin(row), end = std::end(row);
+    if constexpr (has_sortable_adjacency_v<G, Traits>) {
+      if (sorted) {
+        it = lower_bound_adjacent<G, Traits>(it, end, to);
+        return it != end && projection{}(it) == to ? it : end;
+      }
+    }
+    using value_t = std::remove_cv_t<type_traits::range_value_t<std::remove_cv_t<Row>>>;
+    if constexpr (type_traits::range_is_continuous_v<std::remove_cv_t<Row>> && is_vector_searchable_v<value_t> &&
+                  std::is_integral_v<Node>) {
+      // the vector search is not constexpr, the constant evaluation takes the loop below
+      if (!is_constant_evaluated()) {
+        // the target which is not representable as a row element is not in the row
+        const auto value = static_cast<value_t>(to);
+        if (static_cast<Node>(value) != to || (to < Node{}) != (value < value_t{}))
+          return end;
+        return std::next(it, static_cast<std::ptrdiff_t>(find_equal(std::data(row), std::size(row), value)));
+      }
+    }
+    while (it != end && !(projection{}(it) == to))
+      ++it;
+    return it;
+  }
+
+  // one pass over the edges, it is worth before many lookups
+  template<class G, class Traits>
+  constexpr bool adjacency_rows_sorted(G& graph) {
+    using projection = composition_t<first_getter_t, indirect_t>;
+    for (auto&& node : node_indices(graph)) {
+      if (auto* adj = adjacents(&graph, node)) {
+        auto it = std::begin(*adj), end = std::end(*adj);
+        if (it == end)
+          continue;
+        for (auto next = std::next(it); next != end; it = next++)
+          if (projection{}(next) < projection{}(it))
+            return false;
+      }
+    }
+    return true;
+  }
+}
+
+namespace detail {
+  // the target is compared with the row elements as it is, when the row can find it
+  template<class G, class Traits, class Row, class To>
+  constexpr decltype(auto) row_key(To const& to) {
+    if constexpr (std::is_same_v<To, node_t<G, Traits>> || has_transparent_compare_v<std::remove_cv_t<Row>>) {
+      return to;
+    } else {
+      return node_t<G, Traits>(to);
+    }
+  }
+
+  template <class G, class Traits, class From, class To>
+  constexpr auto get_edge_between(G& graph, From const& from, To const& to) -> edge_repr_t<G, Traits> {
+    if constexpr (has_adjacency_container_v<G, Traits>) {
+      if constexpr (has_node_container_v<G, Traits>) {
+        if (auto* adj = adjacents(&graph, from)) {
+          if constexpr (type_traits::is_bitset_v<adjacency_container_t<G, Traits>>) {
+            return iterator::bitset_iterator<std::remove_pointer_t<decltype(adj)>>{adj, static_cast<std::size_t>(to),
+                                                                                  std::size(*adj)};
+          } else if constexpr (representation_v<G, Traits> == representation_t::adjacency_matrix) {
+            if (auto ix = static_cast<std::size_t>(to); ix < std::size(*adj) && cell_present(std::begin(*adj)[ix]))
+              return std::next(std::begin(*adj), ix);
+          } else if constexpr (detail::is_associative<adjacency_container_t, G, Traits>) {
+            if (auto [f, t] = adj->equal_range(row_key<G, Traits, adjacency_container_t<G, Traits>>(to)); f != t) {
+              if constexpr (has_edge_container_v<G, Traits>) {
+                return get_edge(graph, detail::edge_index_getter<G, Traits>{}(f));
+              } else {
+                return f;
+              }
+            }
+          } else if (auto it = detail::find_adjacent<G, Traits>(*adj, to, sorted_adjacency_v<std::remove_cv_t<G>, Traits>);
+                     it != std::end(*adj)) {
             if constexpr (has_edge_container_v<G, Traits>) {
-              return get_edge(graph, detail::edge_index_getter<G, Traits>{}(f));
+              return get_edge(graph, detail::edge_index_getter<G, Traits>{}(it));
             } else {
-              return f;
+              return it;
             }
           }
-        } else {
-          auto it = std::begin(*adj), end = std::end(*adj);
-          while (it != end) {
-            if (detail::composition_t<detail::first_getter_t, detail::indirect_t>{}(it) == to) {
-              if constexpr (has_edge_container_v<G, Traits>) {
-                return get_edge(graph, detail::edge_index_getter<G, Traits>{}(it));
-              } else {
-                return it;
-              }
+        }
+      } else {
+        auto&& adj_mat = detail::adjacent_container_getter<G, Traits>{}(graph);
+        if (auto ix = detail::compressed_matrix_of<G, Traits>(std::size(adj_mat)).index(from, to); ix < std::size(adj_mat))
+          return iterator::bitset_iterator<adjacency_container_t<G, Traits>>{&adj_mat, ix, std::size(adj_mat)};
+      }
+    } else {
+      auto&& edge_list_cont = edge_list(graph);
+      if constexpr (detail::is_associative<edge_list_container_t, G, Traits>) {
+        if (auto [f, t] = edge_list_cont.equal_range({from, to}); f != t) {
+          if constexpr (has_edge_container_v<G, Traits>) {
+            return get_edge(graph, detail::edge_index_getter<G, Traits>{}(f));
+          } else {
+            return f;
+          }
+        }
+      } else {
+        const auto end = std::end(edge_list_cont);
+        auto it = std::begin(edge_list_cont);
+        while (it != end) {
+          if (detail::source_getter<G, Traits>{}(it) == from &&
+              detail::target_getter<G, Traits>{}(it) == to) {
+            if constexpr (has_edge_container_v<G, Traits>) {
+              return get_edge(graph, detail::edge_index_getter<G, Traits>{}(it));
+            } else {
+              return it;
             }
-            ++it;
           }
+          ++it;
         }
       }
+    }
+    return invalid_edge(graph);
+  }
+}
+
+template <class G, class Traits>
+constexpr auto get_edge(G& graph, node_t<G, Traits> const& from, node_t<G, Traits> const& to)
+      -> edge_repr_t<G, Traits> {
+  return detail::get_edge_between<G, Traits>(graph, from, to);
+}
+
+template <class G, class From, class To, class Traits>
+constexpr auto get_edge(G& graph, From const& from, To const& to)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, From> ||
+                          detail::is_transparent_node_key_v<G, Traits, To>, edge_repr_t<G, Traits, true>> {
+  return detail::get_edge_between<G, Traits>(graph, from, to);
+}
+
+namespace detail {
+  template<class G, class Traits, class It>
+  constexpr auto edge_repr_of(G& graph, It const& it) -> edge_repr_t<G, Traits> {
+    if constexpr (has_edge_container_v<G, Traits>) {
+      return get_edge(graph, edge_index_getter<G, Traits>{}(it));
     } else {
-      auto&& adj_mat = detail::adjacent_container_getter<G, Traits>{}(graph);
-      return iterator::bitset_iterator<adjacency_container_t<G, Traits>>{&adj_mat, from * node_count(graph) + to,
-        std::size(adj_mat)};
+      return it;
     }
-  } else {
-    auto&& edge_list_cont = edge_list(graph);
-    if constexpr (detail::is_associative<edge_list_container_t, G, Traits>) {
-      if (auto [f, t] = edge_list_cont.equal_range({from, to}); f != t) {
-        if constexpr (has_edge_container_v<G, Traits>) {
-          return get_edge(graph, detail::edge_index_getter<G, Traits>{}(f));
+  }
+
+  // The queries are grouped by the source, so every adjacency row is fetched once. Sorted rows are searched
+  // forward with the targets in order, long unsorted rows with many queries get a sorted iterator index,
+  // edge lists are grouped by the edge list index when there are more queries than log E. The result is in the
+  // order of the queries.
+  template<class G, class Traits, class InputIt>
+  auto get_edges_of_queries(G& graph, InputIt first, InputIt last) {
+    using node_type = node_t<G, Traits>;
+    struct query {
+      node_type from;
+      node_type to;
+      std::size_t index;
+    };
+
+    std::vector<query> queries;
+    for (; first != last; ++first) {
+      auto&& [from, to] = *first;
+      queries.push_back(query{static_cast<node_type>(from), static_cast<node_type>(to), queries.size()});
+    }
+    std::vector<edge_repr_t<G, Traits>> res(queries.size(), invalid_edge(graph));
+
+    if constexpr (!is_less_comparable_v<node_type> ||
+                  (representation_v<G, Traits> == representation_t::adjacency_matrix) ||
+                  (has_edge_list_container_v<G, Traits> && is_associative<edge_list_container_t, G, Traits>)) {
+      for (auto& q : queries)
+        res[q.index] = get_edge(graph, q.from, q.to);
+    } else {
+      using projection = composition_t<first_getter_t, indirect_t>;
+      const auto by_target = [] (query const& l, query const& r) {
+        return l.to < r.to;
+      };
+
+      if constexpr (has_edge_list_container_v<G, Traits>) {
+        auto&& edge_list_cont = edge_list(graph);
+        const auto edges = static_cast<std::size_t>(std::distance(std::begin(edge_list_cont), std::end(edge_list_cont)));
+        // grouping the edges costs E log E, which pays off only when the queries would scan the list more often
+        if (edges < 2 || queries.size() <= log2(edges)) {
+          for (auto& q : queries)
+            res[q.index] = get_edge(graph, q.from, q.to);
         } else {
-          return f;
+          const iterator::edge_list_index<G, Traits> index(graph);
+          for (auto& q : queries) {
+            for (auto&& [to, repr] : index(q.from)) {
+              if (to == q.to) {
+                res[q.index] = repr;
+                break;
+              }
+            }
+          }
         }
-      }
-    } else {
-      const auto end = std::end(edge_list_cont);
-      auto it = std::begin(edge_list_cont);
-      while (it != end) {
-        if (detail::source_getter<G, Traits>{}(it) == from &&
-            detail::target_getter<G, Traits>{}(it) == to) {
-          if constexpr (has_edge_container_v<G, Traits>) {
-            return get_edge(graph, detail::edge_index_getter<G, Traits>{}(it));
+      } else {
+        if constexpr (is_user_defined_node_type_v<G, Traits>) {
+          std::sort(queries.begin(), queries.end(), [] (query const& l, query const& r) {
+            return l.from < r.from;
+          });
+        } else {
+          // counting sort by the source, the unknown sources remain unanswered
+          const std::size_t n = node_count(graph);
+          std::vector<std::size_t> offsets(n + 1);
+          for (auto& q : queries)
+            if (static_cast<std::size_t>(q.from) < n)
+              ++offsets[static_cast<std::size_t>(q.from) + 1];
+          for (std::size_t i{}; i < n; ++i)
+            offsets[i + 1] += offsets[i];
+
+          std::vector<query> grouped(offsets[n]);
+          for (auto& q : queries)
+            if (static_cast<std::size_t>(q.from) < n)
+              grouped[offsets[static_cast<std::size_t>(q.from)]++] = q;
+          queries = std::move(grouped);
+        }
+
+        for (auto group = queries.begin(), group_end = group; group != queries.end(); group = group_end) {
+          while (group_end != queries.end() && group_end->from == group->from)
+            ++group_end;
+
+          auto* adj = adjacents(&graph, group->from);
+#if defined(__GNUC__) || defined(__clang__)
+          if constexpr (has_sortable_adjacency_v<G, Traits>) {
+            // the row of the next source is loaded while this one is searched
+            if (group_end != queries.end())
+              if (auto* next = adjacents(&graph, group_end->from); next && std::begin(*next) != std::end(*next))
+                __builtin_prefetch(std::addressof(*std::begin(*next)));
+          }
+#endif
+          if (!adj)
+            continue;
+
+          if constexpr (is_associative<adjacency_container_t, G, Traits>) {
+            for (auto q = group; q != group_end; ++q)
+              if (auto it = adj->lower_bound(q->to); it != std::end(*adj) && projection{}(it) == q->to)
+                res[q->index] = edge_repr_of<G, Traits>(graph, it);
+          } else if constexpr (has_sortable_adjacency_v<G, Traits>) {
+            const auto queries_in_row = static_cast<std::size_t>(group_end - group);
+            if (sorted_adjacency_v<std::remove_cv_t<G>, Traits>) {
+              std::sort(group, group_end, by_target);
+              auto pos = std::begin(*adj), end = std::end(*adj);
+              for (auto q = group; q != group_end; ++q) {
+                pos = lower_bound_adjacent<G, Traits>(pos, end, q->to);
+                if (pos != end && projection{}(pos) == q->to)
+                  res[q->index] = edge_repr_of<G, Traits>(graph, pos);
+              }
+            } else if (queries_in_row < 16 || std::size(*adj) < 64) {
+              // the row is in the cache, the linear scans are cheaper than an index
+              for (auto q = group; q != group_end; ++q)
+                if (auto it = find_adjacent<G, Traits>(*adj, q->to, false); it != std::end(*adj))
+                  res[q->index] = edge_repr_of<G, Traits>(graph, it);
+            } else {
+              std::sort(group, group_end, by_target);
+              std::vector<decltype(std::begin(*adj))> sorted;
+              sorted.reserve(std::size(*adj));
+              for (auto it = std::begin(*adj), end = std::end(*adj); it != end; ++it)
+                sorted.push_back(it);
+              std::stable_sort(sorted.begin(), sorted.end(), [] (auto const& l, auto const& r) {
+                return projection{}(l) < projection{}(r);
+              });
+              auto pos = sorted.begin();
+              for (auto q = group; q != group_end; ++q) {
+                pos = std::lower_bound(pos, sorted.end(), q->to, [] (auto const& it, node_type const& to) {
+                  return projection{}(it) < to;
+                });
+                if (pos != sorted.end() && projection{}(*pos) == q->to)
+                  res[q->index] = edge_repr_of<G, Traits>(graph, *pos);
+              }
+            }
           } else {
-            return it;
+            for (auto q = group; q != group_end; ++q)
+              if (auto it = find_adjacent<G, Traits>(*adj, q->to, false); it != std::end(*adj))
+                res[q->index] = edge_repr_of<G, Traits>(graph, it);
           }
         }
-        ++it;
       }
     }
+    return res;
   }
-  return invalid_edge(graph);
+}
+
+template <class G, class Traits, class InputIt, class OutputIt>
+constexpr OutputIt get_edges(G& graph, InputIt first, InputIt last, OutputIt out) {
+  for (auto&& repr : detail::get_edges_of_queries<G, Traits>(graph, first, last))
+    *out++ = repr;
+  return out;
 }
 
 template <class G, class Traits>
@@ -241,6 +515,21 @@ constexpr auto node_property(G* graph, node_t<G, Traits> const& node)
                                          detail::copy_cvref_t<G, node_property_t<G, Traits>>*>(graph, node);
 }
 
+template <class G, class Key, class Traits>
+constexpr auto node_property(G&& graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>,
+                          detail::copy_cvref_t<G&&, node_property_t<G, Traits, true>>> {
+  return detail::get_node_properties<G, Traits, detail::node_property_getter<G, Traits>>(std::forward<G>(graph), node);
+}
+
+template <class G, class Key, class Traits>
+constexpr auto node_property(G* graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>,
+                          detail::copy_cvref_t<G, node_property_t<G, Traits, true>>*> {
+  return detail::get_node_properties_ptr<G, Traits, detail::node_property_getter<G, Traits>,
+                                         detail::copy_cvref_t<G, node_property_t<G, Traits>>*>(graph, node);
+}
+
 template <class G, class Traits>
 constexpr auto edge_property(G&&, edge_repr_t<G, Traits, true> repr)
       -> detail::copy_cvref_t<G&&, edge_property_t<G, Traits>> {
@@ -285,11 +574,13 @@ constexpr std::size_t edge_count(G const& graph) {
   } else if constexpr (has_edge_list_container_v<G, Traits>) {
     return std::size(detail::edge_list_container_getter<G, Traits>{}(graph));
   } else if constexpr (has_node_container_v<G, Traits>) {
-    return 0;
+    std::size_t res{};
+    for (auto&& node : node_indices(graph))
+      res += out_degree(graph, node);
+    return res;
   } else {
-    auto first = iterator::get_first_good(detail::adjacent_container_getter<const G, Traits>{}(graph)),
-         end = decltype(first){};
-    return std::distance(first, end);
+    auto&& adj_mat = detail::adjacent_container_getter<const G, Traits>{}(graph);
+    return detail::count_set(adj_mat, 0, std::size(adj_mat));
   }
 }
 
@@ -298,16 +589,139 @@ constexpr std::size_t adjacency_count(G const& graph) {
   return edge_count(graph);
 }
 
+template<class G, class Traits, bool>
+constexpr std::size_t out_degree(G const& graph, node_t<G, Traits> const& node) {
+  if constexpr (representation_v<G, Traits> == representation_t::adjacency_matrix) {
+    if constexpr (!has_node_container_v<G, Traits>) {
+      auto&& adj_mat = detail::adjacent_container_getter<const G, Traits>{}(graph);
+      const auto m = detail::compressed_matrix_of<G, Traits>(std::size(adj_mat));
+      std::size_t res = detail::count_set(adj_mat, m.row_begin(node), m.row_end(node));
+      if (m.layout == detail::compressed_layout::triangle)
+        for (auto from = static_cast<std::size_t>(node) + 1; from < m.k; ++from)
+          res += static_cast<bool>(adj_mat[m.index(from, node)]);
+      return res;
+    } else if constexpr (type_traits::is_bitset_v<adjacency_container_t<G, Traits>>) {
+      if (auto* adj = adjacents(&graph, node))
+        return detail::count_set(*adj, 0, std::size(*adj));
+      return 0;
+    } else {
+      return out_edges(graph, node).size();
+    }
+  } else if constexpr (has_node_container_v<G, Traits> && has_adjacency_container_v<G, Traits>) {
+    if constexpr (type_traits::detail::has_std_size_v<const adjacency_container_t<G, Traits>>) {
+      if (auto* adj = adjacents(&graph, node))
+        return std::size(*adj);
+      return 0;
+    } else {
+      return out_edges(graph, node).size();
+    }
+  } else {
+    return out_edges(graph, node).size();
+  }
+}
+
+template<class G, class Traits, bool>
+constexpr std::size_t in_degree(G const& graph, node_t<G, Traits> const& node) {
+  if constexpr (representation_v<G, Traits> == representation_t::adjacency_matrix &&
+                !has_in_adjacency_container_v<G, Traits>) {
+    std::size_t res{};
+    if constexpr (!has_node_container_v<G, Traits>) {
+      auto&& adj_mat = detail::adjacent_container_getter<const G, Traits>{}(graph);
+      const auto m = detail::compressed_matrix_of<G, Traits>(std::size(adj_mat));
+      if (m.layout == detail::compressed_layout::triangle)
+        return out_degree(graph, node);
+      for (std::size_t from{}; from < m.k; ++from)
+        if (auto ix = m.index(from, node); ix < std::size(adj_mat))
+          res += static_cast<bool>(adj_mat[ix]);
+    } else if constexpr (type_traits::is_bitset_v<adjacency_container_t<G, Traits>>) {
+      for (auto&& from : node_indices(graph))
+        if (auto* adj = adjacents(&graph, from); adj && static_cast<std::size_t>(node) < std::size(*adj))
+          res += static_cast<bool>((*adj)[node]);
+    } else {
+      res = in_edges(graph, node).size();
+    }
+    return res;
+  } else if constexpr (has_in_adjacency_container_v<G, Traits>) {
+    if constexpr (type_traits::detail::has_std_size_v<const in_adjacency_container_t<G, Traits>>) {
+      if (auto* adj = in_adjacents(&graph, node))
+        return std::size(*adj);
+      return 0;
+    } else {
+      return in_edges(graph, node).size();
+    }
+  } else {
+    // every row is searched for the node, the in_degrees(g) counts all of them with the same pass
+    return in_edges<const G, Traits>(graph, node).size();
+  }
+}
+
+// Degree of every node with one pass over the edges.
+// Indexed by the node for index graphs, a flat hash map for user defined node types with std::hash, otherwise a map
+// ordered by the node.
+template<class G, class Traits, bool>
+auto out_degrees(G const& graph) -> detail::degree_array_t<G, Traits> {
+  detail::degree_array_t<G, Traits> res;
+  if constexpr (has_edge_list_container_v<G, Traits> && !has_adjacency_container_v<G, Traits>) {
+    auto&& edge_list_cont = edge_list(graph);
+    for (auto it = std::begin(edge_list_cont), end = std::end(edge_list_cont); it != end; ++it) {
+      ++res[detail::source_getter<const G, Traits>{}(it)];
+      res.try_emplace(detail::target_getter<const G, Traits>{}(it));
+    }
+  } else if constexpr (is_user_defined_node_type_v<G, Traits>) {
+    for (auto&& node : node_indices(graph))
+      res.try_emplace(node, out_degree(graph, node));
+  } else {
+    res.resize(node_count(graph));
+    for (std::size_t node{}; node < res.size(); ++node)
+      res[node] = out_degree(graph, static_cast<node_t<G, Traits>>(node));
+  }
+  return res;
+}
+
+template<class G, class Traits, bool>
+auto in_degrees(G const& graph) -> detail::degree_array_t<G, Traits> {
+  detail::degree_array_t<G, Traits> res;
+  if constexpr (has_edge_list_container_v<G, Traits> && !has_adjacency_container_v<G, Traits>) {
+    auto&& edge_list_cont = edge_list(graph);
+    for (auto it = std::begin(edge_list_cont), end = std::end(edge_list_cont); it != end; ++it) {
+      ++res[detail::target_getter<const G, Traits>{}(it)];
+      res.try_emplace(detail::source_getter<const G, Traits>{}(it));
+    }
+  } else if constexpr (is_user_defined_node_type_v<G, Traits>) {
+    for (auto&& node : node_indices(graph)) {
+      res.try_emplace(node);
+      for (auto [to, repr] : out_edges(graph, node))
+        ++res[to];
+    }
+  } else if constexpr (has_in_adjacency_container_v<G, Traits>) {
+    res.resize(node_count(graph));
+    for (std::size_t node{}; node < res.size(); ++node)
+      res[node] = in_degree(graph, static_cast<node_t<G, Traits>>(node));
+  } else {
+    res.resize(node_count(graph));
+    for (std::size_t node{}; node < res.size(); ++node)
+      for (auto [to, repr] : out_edges(graph, static_cast<node_t<G, Traits>>(node)))
+        ++res[static_cast<std::size_t>(to)];
+  }
+  return res;
+}
+
 template<class G, class Traits>
 constexpr auto has_node(G const& graph, node_t<G, Traits> const& node)
       -> std::enable_if_t<has_node_container_v<G, Traits> || has_adjacency_container_v<G, Traits>, bool> {
-  if constexpr (has_node_container_v<G, Traits>) {
+  if constexpr (is_user_defined_node_type_v<G, Traits>) {
     return detail::get_node_properties_ptr<const G, Traits, detail::identity_t, bool>(&graph, node);
   } else {
-    return node_count(graph) > node;
+    return detail::is_index_in_range(node, node_count(graph));
   }
 }
 
+template<class G, class Key, class Traits>
+constexpr auto has_node(G const& graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>, bool> {
+  return detail::get_node_properties_ptr<const G, Traits, detail::identity_t, bool>(&graph, node);
+}
+
 template<class Cmp, class G, class Traits>
 constexpr auto has_node(G const& graph, node_t<G, Traits> const& node, Cmp&& cmp)
       -> std::enable_if_t<!has_node_container_v<G, Traits> && !has_adjacency_container_v<G, Traits>, bool> {
@@ -336,6 +750,14 @@ constexpr bool has_edge(G const& graph,
   return get_edge(graph, from, to) != invalid_edge(graph);
 }
 
+template<class G, class Traits, class InputIt, class OutputIt>
+constexpr OutputIt has_edges(G const& graph, InputIt first, InputIt last, OutputIt out) {
+  const auto invalid = invalid_edge(graph);
+  for (auto&& repr : detail::get_edges_of_queries<const G, Traits>(graph, first, last))
+    *out++ = repr != invalid;
+  return out;
+}
+
 template<class G, class Traits, bool>
 constexpr bool has_adjacency(G const& graph,
                              node_t<G, Traits> const& from,
@@ -380,6 +802,37 @@ constexpr auto in_out_edges(G& graph, node_t<G, Traits> const& node)
       -> iterator::in_out_edge_iterable<G, Traits> {
     return {graph, node};
 }
+
+template<class G, class Traits, bool>
+constexpr auto out_edge_index(G& graph)
+      -> std::enable_if_t<has_edge_list_container_v<G, Traits>, iterator::edge_list_index<G, Traits>> {
+  return iterator::edge_list_index<G, Traits>{graph};
+}
+
+template<class G, class Traits, bool>
+constexpr auto out_edge_index(G& graph)
+      -> std::enable_if_t<detail::has_cell_rows_v<G, Traits>, iterator::occupancy_bitmap<G, Traits>> {
+  return iterator::occupancy_bitmap<G, Traits>{graph};
+}
+
+template<class G, class Traits, bool>
+constexpr auto in_edge_index(G& graph)
+      -> std::enable_if_t<has_edge_list_container_v<G, Traits>, iterator::edge_list_index<G, Traits, true>> {
+  return iterator::edge_list_index<G, Traits, true>{graph};
+}
+
+template<class G, class Traits, bool>
+constexpr auto in_edge_index(G& graph)
+      -> std::enable_if_t<has_adjacency_container_v<G, Traits> && !is_user_defined_node_type_v<G, Traits> &&
+                          !detail::has_bitset_rows_v<G, Traits>, iterator::transposed_index<G, Traits>> {
+  return iterator::transposed_index<G, Traits>{graph};
+}
+
+template<class G, class Traits, bool>
+constexpr auto in_edge_index(G& graph)
+      -> std::enable_if_t<detail::has_bitset_rows_v<G, Traits>, iterator::transposed_matrix<G, Traits>> {
+  return iterator::transposed_matrix<G, Traits>{graph};
+}
 }
 
 #endif //BXLX_GRAPH_GETTERS_HPP
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2022-2023 Bela Schaum (schaumb at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BXLX_GRAPH_LINEAR_SEARCH_HPP
+#define BXLX_GRAPH_LINEAR_SEARCH_HPP
+
+#include "bitset_iterator.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define BXLX_GRAPH_SSE2
+#  include <emmintrin.h>
+#  if defined(__SSE4_1__)
+#    include <smmintrin.h>
+#  endif
+#endif
+
+namespace bxlx::graph::detail {
+  // integral elements which are searched by their bytes
+  template<class T>
+  constexpr bool is_vector_searchable_v = std::is_integral_v<T> && !std::is_same_v<std::remove_cv_t<T>, bool> &&
+                                          (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+  // Index of the first element equal to value in [0, n), or n if there is none.
+  // A vector of elements is compared at once and the byte mask of the equal lanes gives the position, the tail and the
+  // element sizes without vector compare are searched by the scalar loop.
+  template<class T>
+  std::size_t find_equal(const T* first, std::size_t n, T value) noexcept {
+    std::size_t i{};
+    if constexpr (is_vector_searchable_v<T>) {
+#if defined(__AVX2__)
+      constexpr std::size_t lanes = sizeof(__m256i) / sizeof(T);
+      const __m256i needle = sizeof(T) == 2 ? _mm256_set1_epi16(static_cast<short>(value)) :
+                             sizeof(T) == 4 ? _mm256_set1_epi32(static_cast<int>(value)) :
+                                              _mm256_set1_epi64x(static_cast<long long>(value));
+      for (; i + lanes <= n; i += lanes) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+        const __m256i eq = sizeof(T) == 2 ? _mm256_cmpeq_epi16(chunk, needle) :
+                           sizeof(T) == 4 ? _mm256_cmpeq_epi32(chunk, needle) :
+                                            _mm256_cmpeq_epi64(chunk, needle);
+        if (const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(eq)))
+          return i + countr_zero(mask) / sizeof(T);
+      }
+#elif defined(BXLX_GRAPH_SSE2)
+#  if !defined(__SSE4_1__)
+      if constexpr (sizeof(T) != 8)
+#  endif
+      {
+        constexpr std::size_t lanes = sizeof(__m128i) / sizeof(T);
+        const __m128i needle = sizeof(T) == 2 ? _mm_set1_epi16(static_cast<short>(value)) :
+                               sizeof(T) == 4 ? _mm_set1_epi32(static_cast<int>(value)) :
+                                                _mm_set1_epi64x(static_cast<long long>(value));
+        for (; i + lanes <= n; i += lanes) {
+          const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+#  if defined(__SSE4_1__)
+          const __m128i eq = sizeof(T) == 2 ? _mm_cmpeq_epi16(chunk, needle) :
+                             sizeof(T) == 4 ? _mm_cmpeq_epi32(chunk, needle) :
+                                              _mm_cmpeq_epi64(chunk, needle);
+#  else
+          const __m128i eq = sizeof(T) == 2 ? _mm_cmpeq_epi16(chunk, needle) : _mm_cmpeq_epi32(chunk, needle);
+#  endif
+          if (const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(eq)))
+            return i + countr_zero(mask) / sizeof(T);
+        }
+      }
+#endif
+    }
+    for (; i < n; ++i)
+      if (first[i] == value)
+        return i;
+    return n;
+  }
+}
+
+#undef BXLX_GRAPH_SSE2
+
+#endif //BXLX_GRAPH_LINEAR_SEARCH_HPP
@@ -3,6 +3,52 @@
 
 #include "getter_types.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace bxlx::graph::detail {
+template<class T, class = void>
+constexpr bool is_less_comparable_v = false;
+template<class T>
+constexpr bool is_less_comparable_v<T, std::void_t<decltype(std::declval<T const&>() < std::declval<T const&>())>> = true;
+
+// edge lists without node container can be indexed with one sort when nodes are compared with the default equality
+template<class G, class Traits, class Cmp>
+constexpr bool has_sorted_node_index_v = !has_node_container_v<G, Traits> && !has_adjacency_container_v<G, Traits> &&
+                                         (std::is_same_v<std::decay_t<Cmp>, std::equal_to<>> ||
+                                          std::is_same_v<std::decay_t<Cmp>, std::equal_to<node_t<G, Traits>>>) &&
+                                         is_less_comparable_v<node_t<G, Traits>>;
+
+// heavy nodes are not copied, only referenced from the graph
+template<class G, class Traits>
+using node_ref_t = std::conditional_t<std::is_trivially_copyable_v<node_t<G, Traits>>,
+                                      node_t<G, Traits>, node_t<G, Traits> const&>;
+
+// storable form of node_ref_t
+template<class G, class Traits>
+using node_handle_t = std::conditional_t<std::is_trivially_copyable_v<node_t<G, Traits>>,
+                                         node_t<G, Traits>, const node_t<G, Traits>*>;
+
+template<class G, class Traits>
+constexpr node_handle_t<G, Traits> to_handle(node_ref_t<G, Traits> node) {
+  if constexpr (std::is_pointer_v<node_handle_t<G, Traits>>) {
+    return std::addressof(node);
+  } else {
+    return node;
+  }
+}
+
+template<class G, class Traits>
+constexpr node_ref_t<G, Traits> from_handle(node_handle_t<G, Traits> const& handle) {
+  if constexpr (std::is_pointer_v<node_handle_t<G, Traits>>) {
+    return *handle;
+  } else {
+    return handle;
+  }
+}
+}
+
 namespace bxlx::graph::iterator {
 
 template<class G, class Traits>
@@ -50,7 +96,7 @@ struct node_iterable<G, Traits, void, std::enable_if_t<has_node_container_v<G, T
     using value_type = node_t<G, Traits>;
     using difference_type = std::ptrdiff_t;
     using pointer = const value_type*;
-    using reference = const value_type&;
+    using reference = detail::node_ref_t<G, Traits>;
     using It = typename node_container_t<G, Traits>::const_iterator;
     It it;
 
@@ -66,7 +112,7 @@ struct node_iterable<G, Traits, void, std::enable_if_t<has_node_container_v<G, T
       return *this;
     }
 
-    constexpr value_type operator*() const {
+    constexpr detail::node_ref_t<G, Traits> operator*() const {
       return detail::composition_t<detail::first_getter_t, detail::indirect_t>{}(it);
     }
   };
@@ -106,9 +152,73 @@ struct node_iterable<G, Traits, void, std::enable_if_t<!has_node_container_v<G,
 };
 
 
+template<class G, class Traits, class Cmp>
+struct node_iterable<G, Traits, Cmp, std::enable_if_t<detail::has_sorted_node_index_v<G, Traits, Cmp>>> {
+  using stored_t = detail::node_handle_t<G, Traits>;
+
+  std::vector<stored_t> index;
+
+  constexpr static auto get = [] (stored_t const& s) -> detail::node_ref_t<G, Traits> {
+    return detail::from_handle<G, Traits>(s);
+  };
+
+  constexpr node_iterable(G& g, Cmp&&) {
+    auto&& list = edge_list(g);
+    index.reserve(2 * static_cast<std::size_t>(std::distance(std::begin(list), std::end(list))));
+    for (auto it = std::begin(list), end = std::end(list); it != end; ++it) {
+      index.push_back(detail::to_handle<G, Traits>(detail::source_getter<G, Traits>{}(it)));
+      index.push_back(detail::to_handle<G, Traits>(detail::target_getter<G, Traits>{}(it)));
+    }
+    std::sort(index.begin(), index.end(), [] (stored_t const& l, stored_t const& r) {
+      return get(l) < get(r);
+    });
+    index.erase(std::unique(index.begin(), index.end(), [] (stored_t const& l, stored_t const& r) {
+      return get(l) == get(r);
+    }), index.end());
+  }
+
+  struct const_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = node_t<G, Traits>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = detail::node_ref_t<G, Traits>;
+    using It = typename std::vector<stored_t>::const_iterator;
+
+    It it;
+
+    constexpr bool operator!=(const_iterator const& rhs) const {
+      return it != rhs.it;
+    }
+
+    constexpr const_iterator& operator++() {
+      ++it;
+      return *this;
+    }
+
+    constexpr detail::node_ref_t<G, Traits> operator*() const {
+      return get(*it);
+    }
+  };
+
+  constexpr const_iterator begin() const {
+    return {index.begin()};
+  }
+
+  constexpr const_iterator end() const {
+    return {index.end()};
+  }
+
+  constexpr std::size_t size() const {
+    return index.size();
+  }
+};
+
+
 template<class G, class Traits, class Cmp>
 struct node_iterable<G, Traits, Cmp, std::enable_if_t<!has_node_container_v<G, Traits> &&
-                                                      !has_adjacency_container_v<G, Traits>>> {
+                                                      !has_adjacency_container_v<G, Traits> &&
+                                                      !detail::has_sorted_node_index_v<G, Traits, Cmp>>> {
   G& g;
   Cmp&& cmp;
 
@@ -117,7 +227,7 @@ struct node_iterable<G, Traits, Cmp, std::enable_if_t<!has_node_container_v<G, T
     using value_type = node_t<G, Traits>;
     using difference_type = std::ptrdiff_t;
     using pointer = const value_type*;
-    using reference = const value_type&;
+    using reference = detail::node_ref_t<G, Traits>;
     using It = bxlx::graph::type_traits::detail::std_begin_t<const edge_list_container_t<G, Traits>>;
 
     constexpr static auto source = detail::source_getter<G, Traits>{};
@@ -141,7 +251,7 @@ struct node_iterable<G, Traits, Cmp, std::enable_if_t<!has_node_container_v<G, T
     }
 
     constexpr bool check() const {
-      auto v = **this;
+      auto&& v = **this;
 
       if (first && cmp(v, target(it)))
         return false;
@@ -169,7 +279,7 @@ struct node_iterable<G, Traits, Cmp, std::enable_if_t<!has_node_container_v<G, T
       return *this;
     }
 
-    constexpr value_type operator*() const {
+    constexpr detail::node_ref_t<G, Traits> operator*() const {
       if (first) {
         return source(it);
       } else {
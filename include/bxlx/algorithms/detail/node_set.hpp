@@ -4,8 +4,20 @@
 #include "../interface.hpp"
 #include "bitset_iterator.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <climits>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
 #include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace bxlx::graph::detail {
 template<class T>
@@ -18,63 +30,683 @@ constexpr T log2_ceil(T x) {
   return x == T{1} ? T{} : log2(x - 1) + 1;
 }
 
-/*
+constexpr std::size_t dynamic_node_size = std::numeric_limits<std::size_t>::max();
+
+// Graphs with a compile time node bound store the node states in a fixed word array.
+template<std::size_t Size, std::size_t NodesPerSet>
+struct packed_node_words {
+  std::array<std::uint64_t, (Size + (NodesPerSet - 1)) / NodesPerSet> bitset {};
+
+  constexpr std::size_t size() const noexcept {
+    return Size;
+  }
+};
+
+// Runtime sized index graphs allocate the words once, for all nodes, before the traversal.
+template<std::size_t NodesPerSet>
+struct packed_node_words<dynamic_node_size, NodesPerSet> {
+  std::vector<std::uint64_t> bitset {};
+  std::size_t nodes {};
+
+  void resize_nodes(std::size_t n) {
+    if (nodes < n) {
+      nodes = n;
+      bitset.resize((n + (NodesPerSet - 1)) / NodesPerSet);
+    }
+  }
+
+  constexpr std::size_t size() const noexcept {
+    return nodes;
+  }
+};
+
+// a multi state node is in the set when it is not white
+template<class ToType>
+struct visited_bits {
+  constexpr bool operator==(ToType state) const {
+    return state != ToType{};
+  }
+};
+
+// Index nodes store their states packed into words, log2_ceil(States) bits per node.
+// Two states are a plain bitset, the three DFS colours use two bits.
+template<class G, class Traits>
+constexpr bool has_packed_node_set_v = !is_user_defined_node_type_v<G, Traits, true>;
+
+template<class Node, std::size_t Size, std::size_t States>
+struct packed_node_set : packed_node_words<Size, sizeof(std::uint64_t) * CHAR_BIT / log2_ceil(States)> {
+  constexpr static std::size_t BITS_PER_SET = sizeof(std::uint64_t) * CHAR_BIT;
+  constexpr static std::size_t USED_BITS_PER_NODE = log2_ceil(States);
+  constexpr static std::size_t NODES_PER_SET = BITS_PER_SET / USED_BITS_PER_NODE;
+  constexpr static std::uint64_t BIT_MASK = (std::uint64_t{1} << USED_BITS_PER_NODE) - 1;
+
+  using packed_node_words<Size, NODES_PER_SET>::bitset;
+  using packed_node_words<Size, NODES_PER_SET>::size;
+
+  using ToType = std::conditional_t<USED_BITS_PER_NODE == 1, bool, std::size_t>;
+
+  using const_iterator = iterator::bitset_iterator<const packed_node_set,
+                                                   std::conditional_t<USED_BITS_PER_NODE == 1, iterator::good_bits,
+                                                                      visited_bits<ToType>>,
+                                                   Node>;
+
+  constexpr const_iterator begin() const {
+    return {this, static_cast<Node>(find_next_set(*this, 0, size())), static_cast<Node>(size())};
+  }
+
+  constexpr const_iterator end() const {
+    return {this, static_cast<Node>(size()), static_cast<Node>(size())};
+  }
+
+  struct reference {
+    packed_node_set* obj;
+    std::size_t ix;
+
+    constexpr operator ToType() const noexcept {
+      return static_cast<const packed_node_set&>(*obj)[ix];
+    }
+
+    constexpr reference& operator=(ToType res) noexcept {
+      std::uint64_t& word = obj->bitset[ix / NODES_PER_SET];
+      const std::size_t shift = ix % NODES_PER_SET * USED_BITS_PER_NODE;
+      word ^= ((word >> shift ^ static_cast<std::uint64_t>(res)) & BIT_MASK) << shift;
+      return *this;
+    }
+  };
+
+  constexpr reference operator[](Node const& n) {
+    return {this, static_cast<std::size_t>(n)};
+  }
+
+  constexpr ToType operator[](Node const& n) const {
+    const auto ix = static_cast<std::size_t>(n);
+    return static_cast<ToType>(bitset[ix / NODES_PER_SET] >> (ix % NODES_PER_SET * USED_BITS_PER_NODE) & BIT_MASK);
+  }
+
+  // the two state set is a plain packed bitset, so the word level scans apply to it
+  template<std::size_t Bits = USED_BITS_PER_NODE, std::enable_if_t<Bits == 1>* = nullptr>
+  constexpr const std::uint64_t* words() const noexcept {
+    return bitset.data();
+  }
+};
+
 template<class G, class Traits, class States>
-struct node_set<G, Traits, States,
-                std::enable_if_t<max_node_size_v<G, Traits> != std::numeric_limits<std::size_t>::max()>> {
+struct node_set<G, Traits, States, std::enable_if_t<has_packed_node_set_v<G, Traits>>> {
+  using type = packed_node_set<node_t<G, Traits>, max_node_size_v<G, Traits>, States::value>;
+};
+
+// Reusable states of repeated traversals over the same index graph. Every node keeps the stamp of its last write, and
+// a traversal owns the States - 1 stamps above the epoch, so the stamps of the earlier traversals read as white.
+// clear() starts a new traversal by moving the epoch, the stamps are rewritten only when the counter wraps around.
+template<class Node, std::size_t States>
+struct epoch_node_set {
+  constexpr static std::uint32_t STAMPS_PER_EPOCH = States - 1;
+
+  using ToType = std::conditional_t<States == 2, bool, std::size_t>;
+  std::vector<std::uint32_t> stamps {};
+  std::uint32_t epoch {};
+
+  using const_iterator = iterator::bitset_iterator<const epoch_node_set, visited_bits<ToType>, Node>;
+
+  constexpr const_iterator begin() const {
+    return {this, static_cast<Node>(find_next_set(*this, 0, size())), static_cast<Node>(size())};
+  }
+
+  constexpr const_iterator end() const {
+    return {this, static_cast<Node>(size()), static_cast<Node>(size())};
+  }
+
+  struct reference {
+    epoch_node_set* obj;
+    std::size_t ix;
+
+    constexpr operator ToType() const noexcept {
+      return static_cast<const epoch_node_set&>(*obj)[ix];
+    }
+
+    constexpr reference& operator=(ToType res) noexcept {
+      obj->stamps[ix] = res ? obj->epoch + static_cast<std::uint32_t>(res) : std::uint32_t{};
+      return *this;
+    }
+  };
+
+  constexpr reference operator[](Node const& n) {
+    return {this, static_cast<std::size_t>(n)};
+  }
+
+  constexpr ToType operator[](Node const& n) const noexcept {
+    const std::uint32_t stamp = stamps[static_cast<std::size_t>(n)];
+    return stamp > epoch ? static_cast<ToType>(stamp - epoch) : ToType{};
+  }
+
+  void clear() {
+    if (epoch > std::numeric_limits<std::uint32_t>::max() - 2 * STAMPS_PER_EPOCH) {
+      std::fill(stamps.begin(), stamps.end(), std::uint32_t{});
+      epoch = 0;
+    } else {
+      epoch += STAMPS_PER_EPOCH;
+    }
+  }
+
+  void resize_nodes(std::size_t n) {
+    if (stamps.size() < n)
+      stamps.resize(n);
+  }
+
+  constexpr std::size_t size() const noexcept {
+    return stamps.size();
+  }
+};
+
+// the first probed slot of a table with 2^(64 - shift) slots. Fibonacci hashing spreads the sequential hashes
+template<class Node>
+constexpr std::size_t hash_slot(Node const& n, std::size_t shift) noexcept {
+  return static_cast<std::size_t>(static_cast<std::uint64_t>(std::hash<Node>{}(n)) * 0x9E3779B97F4A7C15ull >> shift);
+}
+
+// Visited index nodes shared by the threads of a parallel traversal. claim() sets the bit of the node and tells whether
+// this call was the one which set it, so every node is expanded by exactly one thread. The words are allocated by
+// resize_nodes before the threads start.
+template<class Node>
+struct atomic_node_set {
   constexpr static std::size_t BITS_PER_SET = sizeof(std::uint64_t) * CHAR_BIT;
-  constexpr static std::size_t USED_BITS_PER_NODE = log2_ceil(States::value);
-  constexpr static std::size_t BIT_MASK = (1 << USED_BITS_PER_NODE) - 1;
-  std::array<std::uint64_t, (max_node_size_v<G, Traits> * USED_BITS_PER_NODE + (BITS_PER_SET - 1) ) / BITS_PER_SET> bitset {};
 
-  using const_iterator = iterator::bitset_iterator<const node_set, iterator::good_bits, node_t<G, Traits>>;
-  using iterator = iterator::bitset_iterator<node_set, iterator::all_bits, node_t<G, Traits>>;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> bitset {};
+  std::size_t nodes {};
+
+  using const_iterator = iterator::bitset_iterator<const atomic_node_set, iterator::good_bits, Node>;
 
   constexpr const_iterator begin() const {
-    return iterator::get_first_good(*this);
+    return {this, static_cast<Node>(find_next_set(*this, 0, size())), static_cast<Node>(size())};
   }
 
   constexpr const_iterator end() const {
-    return {this, size(), size()};
+    return {this, static_cast<Node>(size()), static_cast<Node>(size())};
+  }
+
+  bool claim(Node const& n) noexcept {
+    const auto ix = static_cast<std::size_t>(n);
+    std::atomic<std::uint64_t>& word = bitset[ix / BITS_PER_SET];
+    const std::uint64_t bit = std::uint64_t{1} << ix % BITS_PER_SET;
+    // the visited nodes are rejected without a read-modify-write on the shared word
+    if (word.load(std::memory_order_relaxed) & bit)
+      return false;
+    return !(word.fetch_or(bit, std::memory_order_acq_rel) & bit);
   }
 
   struct reference {
-    using ToType = std::conditional_t<USED_BITS_PER_NODE == 1, bool, std::size_t>;
-    iterator it;
+    atomic_node_set* obj;
+    std::size_t ix;
 
-    constexpr operator ToType() const {
-      auto ix = it.index;
-      return (it.obj->bitset[ix / (BITS_PER_SET / USED_BITS_PER_NODE)] >> (ix % (BITS_PER_SET / USED_BITS_PER_NODE))) & BIT_MASK;
+    operator bool() const noexcept {
+      return static_cast<const atomic_node_set&>(*obj)[ix];
     }
 
-    constexpr reference& operator=(std::conditional_t<USED_BITS_PER_NODE == 1, bool, std::size_t> res) {
-      auto ix = it.index;
-      it.obj->bitset[ix / (BITS_PER_SET / USED_BITS_PER_NODE)] ^= ((res & BIT_MASK) ^ static_cast<ToType>(*this)) << (ix % (BITS_PER_SET / USED_BITS_PER_NODE));
+    reference& operator=(bool res) noexcept {
+      const std::uint64_t bit = std::uint64_t{1} << ix % BITS_PER_SET;
+      if (res)
+        obj->bitset[ix / BITS_PER_SET].fetch_or(bit, std::memory_order_acq_rel);
+      else
+        obj->bitset[ix / BITS_PER_SET].fetch_and(~bit, std::memory_order_acq_rel);
       return *this;
     }
   };
 
-  constexpr reference operator[](node_t<G, Traits> const& n) {
-    return {{this, n, static_cast<node_t<G, Traits>>(size())}};
+  reference operator[](Node const& n) noexcept {
+    return {this, static_cast<std::size_t>(n)};
+  }
+
+  bool operator[](Node const& n) const noexcept {
+    const auto ix = static_cast<std::size_t>(n);
+    return bitset[ix / BITS_PER_SET].load(std::memory_order_acquire) >> ix % BITS_PER_SET & 1;
+  }
+
+  void resize_nodes(std::size_t n) {
+    if (nodes >= n)
+      return;
+    const std::size_t words = (n + (BITS_PER_SET - 1)) / BITS_PER_SET;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> grown{new std::atomic<std::uint64_t>[words]()};
+    for (std::size_t i{}; i < (nodes + (BITS_PER_SET - 1)) / BITS_PER_SET; ++i)
+      grown[i].store(bitset[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    bitset = std::move(grown);
+    nodes = n;
   }
 
   constexpr std::size_t size() const noexcept {
-    return max_node_size_v<G, Traits>;
+    return nodes;
+  }
+};
+
+// User defined nodes shared by the threads of a parallel traversal, in a fixed capacity open addressing table. The
+// thread which wins an empty slot writes the node and publishes it, the others wait for the node before they compare.
+// The capacity is set by resize_nodes before the threads start, and a claimed node is never removed.
+template<class Node>
+struct concurrent_hash_node_set {
+  enum slot_state : std::uint8_t { empty, writing, ready };
+
+  struct slot {
+    std::atomic<std::uint8_t> state;
+    Node node;
+  };
+  std::unique_ptr<slot[]> slots {};
+  std::size_t capacity {};
+  std::size_t shift {};
+
+  struct const_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Node*;
+    using reference = const Node&;
+
+    const slot* it;
+    const slot* last;
+
+    constexpr bool operator!=(const_iterator const& rhs) const {
+      return it != rhs.it;
+    }
+
+    constexpr bool operator==(const_iterator const& rhs) const {
+      return it == rhs.it;
+    }
+
+    const_iterator& operator++() {
+      ++it;
+      return skip();
+    }
+
+    const_iterator& skip() {
+      while (it != last && it->state.load(std::memory_order_acquire) != ready)
+        ++it;
+      return *this;
+    }
+
+    constexpr reference operator*() const {
+      return it->node;
+    }
+  };
+
+  const_iterator begin() const {
+    return const_iterator{slots.get(), slots.get() + capacity}.skip();
+  }
+
+  const_iterator end() const {
+    return {slots.get() + capacity, slots.get() + capacity};
+  }
+
+  // the slot of the node, or the empty slot where it belongs, or capacity when the table is full
+  template<bool insert>
+  std::size_t find(Node const& n) const noexcept {
+    if (!capacity)
+      return capacity;
+    std::size_t ix = hash_slot(n, shift);
+    for (std::size_t probes{}; probes < capacity; ++probes, ix = (ix + 1) & (capacity - 1)) {
+      std::uint8_t state = slots[ix].state.load(std::memory_order_acquire);
+      if (state == empty) {
+        if constexpr (insert) {
+          std::uint8_t expected = empty;
+          if (slots[ix].state.compare_exchange_strong(expected, writing, std::memory_order_acq_rel))
+            return ix;
+          state = expected;
+        } else {
+          return ix;
+        }
+      }
+      while (state == writing)
+        state = slots[ix].state.load(std::memory_order_acquire);
+      if (slots[ix].node == n)
+        return ix;
+    }
+    return capacity;
+  }
+
+  bool claim(Node const& n) {
+    const std::size_t ix = find<true>(n);
+    if (ix == capacity)
+      throw_or_terminate<std::length_error>("concurrent node set is full");
+    if (slots[ix].state.load(std::memory_order_acquire) != writing)
+      return false;
+    slots[ix].node = n;
+    slots[ix].state.store(ready, std::memory_order_release);
+    return true;
+  }
+
+  // the node is copied, so the reference outlives the argument of operator[]
+  struct reference {
+    concurrent_hash_node_set* obj;
+    Node node;
+
+    operator bool() const noexcept {
+      return static_cast<const concurrent_hash_node_set&>(*obj)[node];
+    }
+
+    // a claimed node stays in the set
+    reference& operator=(bool res) {
+      if (res)
+        obj->claim(node);
+      return *this;
+    }
+  };
+
+  reference operator[](Node const& n) {
+    return {this, n};
+  }
+
+  bool operator[](Node const& n) const noexcept {
+    const std::size_t ix = find<false>(n);
+    return ix != capacity && slots[ix].state.load(std::memory_order_acquire) == ready;
+  }
+
+  // room for n nodes with at most half of the slots used, the claimed nodes are kept
+  void resize_nodes(std::size_t n) {
+    std::size_t grown = 16;
+    while (grown < 2 * n)
+      grown *= 2;
+    if (grown <= capacity)
+      return;
+
+    concurrent_hash_node_set old{std::unique_ptr<slot[]>{new slot[grown]()}, grown,
+                                 sizeof(std::uint64_t) * CHAR_BIT - log2(grown)};
+    std::swap(*this, old);
+    for (std::size_t i{}; i < old.capacity; ++i)
+      if (old.slots[i].state.load(std::memory_order_relaxed) == ready)
+        claim(old.slots[i].node);
+  }
+};
+
+// User defined nodes with std::hash are stored in a flat open addressing table with linear probing. The state byte is
+// kept inline next to the node, 0 marks the empty slots, so a lookup reads one contiguous run of slots.
+template<class G, class Traits>
+constexpr bool has_hash_node_set_v = is_user_defined_node_type_v<G, Traits, true> &&
+                                     std::is_default_constructible_v<std::hash<node_t<G, Traits, true>>> &&
+                                     std::is_default_constructible_v<node_t<G, Traits, true>>;
+
+template<class Node, std::size_t States>
+struct hash_node_set {
+  using ToType = std::conditional_t<States == 2, bool, std::size_t>;
+
+  struct slot {
+    Node node;
+    std::uint8_t state;
+  };
+  std::vector<slot> slots {};
+  std::size_t stored {};
+  std::size_t shift {};
+
+  struct const_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Node*;
+    using reference = const Node&;
+
+    const slot* it;
+    const slot* last;
+
+    constexpr bool operator!=(const_iterator const& rhs) const {
+      return it != rhs.it;
+    }
+
+    constexpr bool operator==(const_iterator const& rhs) const {
+      return it == rhs.it;
+    }
+
+    constexpr const_iterator& operator++() {
+      ++it;
+      return skip();
+    }
+
+    // the stored white nodes are not in the set
+    constexpr const_iterator& skip() {
+      while (it != last && it->state <= 1)
+        ++it;
+      return *this;
+    }
+
+    constexpr reference operator*() const {
+      return it->node;
+    }
+  };
+
+  constexpr const_iterator begin() const {
+    return const_iterator{slots.data(), slots.data() + slots.size()}.skip();
+  }
+
+  constexpr const_iterator end() const {
+    return {slots.data() + slots.size(), slots.data() + slots.size()};
+  }
+
+  // the node is copied, so the reference outlives the argument of operator[]
+  struct reference {
+    hash_node_set* obj;
+    Node node;
+
+    constexpr operator ToType() const noexcept {
+      return static_cast<const hash_node_set&>(*obj)[node];
+    }
+
+    reference& operator=(ToType res) {
+      obj->assign(node, static_cast<std::uint8_t>(res) + 1);
+      return *this;
+    }
+  };
+
+  constexpr reference operator[](Node const& n) {
+    return {this, n};
+  }
+
+  constexpr ToType operator[](Node const& n) const noexcept {
+    if (slots.empty())
+      return ToType{};
+    const slot& s = slots[find(n)];
+    return s.state ? static_cast<ToType>(s.state - 1) : ToType{};
+  }
+
+  // room for n nodes with at most half of the slots used, the stored nodes are kept
+  void resize_nodes(std::size_t n) {
+    std::size_t capacity = 16;
+    while (capacity < 2 * n)
+      capacity *= 2;
+    if (capacity <= slots.size())
+      return;
+
+    std::vector<slot> old(capacity);
+    old.swap(slots);
+    shift = sizeof(std::uint64_t) * CHAR_BIT - log2(capacity);
+    for (slot& s : old)
+      if (s.state)
+        slots[find(s.node)] = std::move(s);
+  }
+
+  // forgets every node, linear in the capacity which is kept for the next traversal
+  void clear() noexcept {
+    for (slot& s : slots)
+      s.state = 0;
+    stored = 0;
+  }
+
+  // the slot of the node, or the empty slot where it belongs
+  constexpr std::size_t find(Node const& n) const noexcept {
+    const std::size_t mask = slots.size() - 1;
+    std::size_t ix = hash_slot(n, shift);
+    while (slots[ix].state && !(slots[ix].node == n))
+      ix = (ix + 1) & mask;
+    return ix;
   }
 
-  using type = node_set<G, Traits, States>;
+  void assign(Node const& n, std::uint8_t state) {
+    if (2 * (stored + 1) > slots.size())
+      resize_nodes(stored + 1);
+    slot& s = slots[find(n)];
+    if (!s.state) {
+      s.node = n;
+      ++stored;
+    }
+    s.state = state;
+  }
+};
+
+template<class G, class Traits, class States>
+struct node_set<G, Traits, States, std::enable_if_t<has_hash_node_set_v<G, Traits>>> {
+  using type = hash_node_set<node_t<G, Traits>, States::value>;
 };
- */
 
 template<class G, class Traits, class States>
-struct node_set<G, Traits, States, std::enable_if_t</*max_node_size_v<G, Traits> == std::numeric_limits<std::size_t>::max() &&*/ States{} == 2>> {
+struct node_set<G, Traits, States, std::enable_if_t<!has_packed_node_set_v<G, Traits> && !has_hash_node_set_v<G, Traits> &&
+                                                    States{} == 2>> {
   using type = std::set<node_t<G, Traits>>;
 };
 
 template<class G, class Traits, class States>
-struct node_set<G, Traits, States, std::enable_if_t<(States{} > 2)>> {
+struct node_set<G, Traits, States, std::enable_if_t<!has_packed_node_set_v<G, Traits> && !has_hash_node_set_v<G, Traits> &&
+                                                    (States{} > 2)>> {
   using type = std::multiset<node_t<G, Traits>>;
 };
+
+// A value per user defined node in a flat open addressing table, probed like the hash_node_set.
+template<class Node, class Value>
+struct hash_node_map {
+  using value_type = std::pair<Node, Value>;
+
+  struct slot {
+    value_type entry;
+    bool used;
+  };
+  std::vector<slot> slots {};
+  std::size_t stored {};
+  std::size_t shift {};
+
+  struct const_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = hash_node_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    const slot* it;
+    const slot* last;
+
+    constexpr bool operator!=(const_iterator const& rhs) const {
+      return it != rhs.it;
+    }
+
+    constexpr bool operator==(const_iterator const& rhs) const {
+      return it == rhs.it;
+    }
+
+    constexpr const_iterator& operator++() {
+      ++it;
+      return skip();
+    }
+
+    constexpr const_iterator& skip() {
+      while (it != last && !it->used)
+        ++it;
+      return *this;
+    }
+
+    constexpr reference operator*() const {
+      return it->entry;
+    }
+
+    constexpr pointer operator->() const {
+      return &it->entry;
+    }
+  };
+
+  constexpr const_iterator begin() const {
+    return const_iterator{slots.data(), slots.data() + slots.size()}.skip();
+  }
+
+  constexpr const_iterator end() const {
+    return {slots.data() + slots.size(), slots.data() + slots.size()};
+  }
+
+  constexpr std::size_t size() const noexcept {
+    return stored;
+  }
+
+  Value& operator[](Node const& n) {
+    return try_emplace(n).first->second;
+  }
+
+  std::pair<value_type*, bool> try_emplace(Node const& n, Value value = {}) {
+    if (2 * (stored + 1) > slots.size())
+      reserve(stored + 1);
+    slot& s = slots[find(n)];
+    if (s.used)
+      return {&s.entry, false};
+    s.entry = {n, std::move(value)};
+    s.used = true;
+    ++stored;
+    return {&s.entry, true};
+  }
+
+  constexpr std::size_t count(Node const& n) const noexcept {
+    return !slots.empty() && slots[find(n)].used;
+  }
+
+  constexpr Value const& at(Node const& n) const {
+    if (!count(n))
+      throw_or_terminate<std::out_of_range>("Cannot find node");
+    return slots[find(n)].entry.second;
+  }
+
+  // room for n nodes with at most half of the slots used, the stored values are kept
+  void reserve(std::size_t n) {
+    std::size_t capacity = 16;
+    while (capacity < 2 * n)
+      capacity *= 2;
+    if (capacity <= slots.size())
+      return;
+
+    std::vector<slot> old(capacity);
+    old.swap(slots);
+    shift = sizeof(std::uint64_t) * CHAR_BIT - log2(capacity);
+    for (slot& s : old)
+      if (s.used)
+        slots[find(s.entry.first)] = std::move(s);
+  }
+
+  // the slot of the node, or the empty slot where it belongs
+  constexpr std::size_t find(Node const& n) const noexcept {
+    const std::size_t mask = slots.size() - 1;
+    std::size_t ix = hash_slot(n, shift);
+    while (slots[ix].used && !(slots[ix].entry.first == n))
+      ix = (ix + 1) & mask;
+    return ix;
+  }
+};
+
+// the degrees are indexed by the index nodes, hashed or ordered by the user defined nodes
+template<class G, class Traits>
+struct degree_array<G, Traits, std::enable_if_t<has_packed_node_set_v<G, Traits>>> {
+  using type = std::vector<std::size_t>;
+};
+
+template<class G, class Traits>
+struct degree_array<G, Traits, std::enable_if_t<has_hash_node_set_v<G, Traits>>> {
+  using type = hash_node_map<node_t<G, Traits>, std::size_t>;
+};
+
+template<class G, class Traits>
+struct degree_array<G, Traits, std::enable_if_t<!has_packed_node_set_v<G, Traits> && !has_hash_node_set_v<G, Traits>>> {
+  using type = std::map<node_t<G, Traits>, std::size_t>;
+};
+
+template<class NodeSet, class = void>
+constexpr bool is_dynamic_node_set_v = false;
+template<class NodeSet>
+constexpr bool is_dynamic_node_set_v<NodeSet, std::void_t<decltype(std::declval<NodeSet&>().resize_nodes(std::size_t{}))>> = true;
+
+// the runtime sized node sets are sized once from the node count at the start of the traversal, when it is known without
+// a pass over the edges. The states which are already in the set are kept
+template<class G, class Traits, class NodeSet>
+constexpr void init_node_set(G const& g, NodeSet& nodes) {
+  if constexpr (is_dynamic_node_set_v<NodeSet> && node_count_cost_v<G, Traits> == cost_t::constant) {
+    nodes.resize_nodes(node_count(g));
+  }
+}
 }
 
 #endif //BXLX_GRAPH_NODE_SET_HPP
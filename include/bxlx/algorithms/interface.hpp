@@ -35,6 +35,18 @@ namespace iterator {
 
   template<class G, class Traits, class = void>
   struct in_out_edge_iterable;
+
+  template<class G, class Traits, bool in_edges = false>
+  struct edge_list_index;
+
+  template<class G, class Traits>
+  struct transposed_index;
+
+  template<class G, class Traits>
+  struct transposed_matrix;
+
+  template<class G, class Traits>
+  struct occupancy_bitmap;
 }
 namespace detail {
   using type_traits::detail::copy_cvref_t;
@@ -45,6 +57,12 @@ namespace detail {
 
   template<class G, class Traits = graph_traits<G>, class States = store_bool, bool = it_is_a_graph_v<G, Traits>>
   using node_set_t = typename node_set<G, Traits, States>::type;
+
+  template<class G, class Traits, class = void>
+  struct degree_array;
+
+  template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+  using degree_array_t = typename degree_array<G, Traits>::type;
 }
 
 template <class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
@@ -64,6 +82,17 @@ template <class G, class Traits = graph_traits<G>>
 constexpr auto adjacents(G* graph, node_t<G, Traits> const& node)
       -> detail::copy_cvref_t<G, adjacency_container_t<G, Traits>>*;
 
+// Heterogeneous lookups: with a transparent node container comparator the key is not converted to node_t.
+template <class G, class Key, class Traits = graph_traits<G>>
+constexpr auto adjacents(G&& graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>,
+                          detail::copy_cvref_t<G&&, adjacency_container_t<G, Traits, true>>>;
+
+template <class G, class Key, class Traits = graph_traits<G>>
+constexpr auto adjacents(G* graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>,
+                          detail::copy_cvref_t<G, adjacency_container_t<G, Traits, true>>*>;
+
 template <class G, class Traits = graph_traits<G>>
 constexpr auto in_adjacents(G&& graph, node_t<G, Traits, true> const& node)
       -> detail::copy_cvref_t<G&&, in_adjacency_container_t<G, Traits>>;
@@ -90,6 +119,14 @@ template <class G, class Traits = graph_traits<G>>
 constexpr auto get_edge(G& graph, node_t<G, Traits> const& from, node_t<G, Traits> const& to)
       -> edge_repr_t<G, Traits>;
 
+template <class G, class From, class To, class Traits = graph_traits<G>>
+constexpr auto get_edge(G& graph, From const& from, To const& to)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, From> ||
+                          detail::is_transparent_node_key_v<G, Traits, To>, edge_repr_t<G, Traits, true>>;
+
+template <class G, class Traits = graph_traits<G>, class InputIt, class OutputIt>
+constexpr OutputIt get_edges(G& graph, InputIt first, InputIt last, OutputIt out);
+
 template <class G, class Traits = graph_traits<G>>
 constexpr auto equal_edges(G& graph, node_t<G, Traits> const& from, node_t<G, Traits> const& to)
       -> std::pair<edge_repr_t<G, Traits>, edge_repr_t<G, Traits>>;
@@ -113,6 +150,16 @@ template <class G, class Traits = graph_traits<G>>
 constexpr auto node_property(G* graph, node_t<G, Traits> const& node)
       -> detail::copy_cvref_t<G, node_property_t<G, Traits>>*;
 
+template <class G, class Key, class Traits = graph_traits<G>>
+constexpr auto node_property(G&& graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>,
+                          detail::copy_cvref_t<G&&, node_property_t<G, Traits, true>>>;
+
+template <class G, class Key, class Traits = graph_traits<G>>
+constexpr auto node_property(G* graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>,
+                          detail::copy_cvref_t<G, node_property_t<G, Traits, true>>*>;
+
 template <class G, class Traits = graph_traits<G>>
 constexpr auto edge_property(G&&, edge_repr_t<G, Traits, true> repr)
       -> detail::copy_cvref_t<G&&, edge_property_t<G, Traits>>;
@@ -139,10 +186,26 @@ constexpr std::size_t edge_count(G const& graph);
 template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
 constexpr std::size_t adjacency_count(G const& graph);
 
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr std::size_t out_degree(G const& graph, node_t<G, Traits> const& node);
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr std::size_t in_degree(G const& graph, node_t<G, Traits> const& node);
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+auto out_degrees(G const& graph) -> detail::degree_array_t<G, Traits>;
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+auto in_degrees(G const& graph) -> detail::degree_array_t<G, Traits>;
+
 template<class G, class Traits = graph_traits<G>>
 constexpr auto has_node(G const& graph, node_t<G, Traits> const& node)
       -> std::enable_if_t<has_node_container_v<G, Traits> || has_adjacency_container_v<G, Traits>, bool>;
 
+template<class G, class Key, class Traits = graph_traits<G>>
+constexpr auto has_node(G const& graph, Key const& node)
+      -> std::enable_if_t<detail::is_transparent_node_key_v<G, Traits, Key>, bool>;
+
 template<class Cmp = std::equal_to<>, class G, class Traits = graph_traits<G>>
 constexpr auto has_node(G const& graph, node_t<G, Traits> const& node, Cmp&& cmp = {})
       -> std::enable_if_t<!has_node_container_v<G, Traits> && !has_adjacency_container_v<G, Traits>, bool>;
@@ -155,6 +218,9 @@ constexpr bool has_edge(G const& graph,
                         node_t<G, Traits> const& from,
                         node_t<G, Traits> const& to);
 
+template<class G, class Traits = graph_traits<G>, class InputIt, class OutputIt>
+constexpr OutputIt has_edges(G const& graph, InputIt first, InputIt last, OutputIt out);
+
 template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
 constexpr bool has_adjacency(G const& graph,
                              node_t<G, Traits> const& from,
@@ -180,6 +246,27 @@ constexpr auto in_edges(G& graph, node_t<G, Traits> const& node)
 template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
 constexpr auto in_out_edges(G& graph, node_t<G, Traits> const& node)
       -> iterator::in_out_edge_iterable<G, Traits>;
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr auto out_edge_index(G& graph)
+      -> std::enable_if_t<has_edge_list_container_v<G, Traits>, iterator::edge_list_index<G, Traits>>;
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr auto out_edge_index(G& graph)
+      -> std::enable_if_t<detail::has_cell_rows_v<G, Traits>, iterator::occupancy_bitmap<G, Traits>>;
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr auto in_edge_index(G& graph)
+      -> std::enable_if_t<has_edge_list_container_v<G, Traits>, iterator::edge_list_index<G, Traits, true>>;
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr auto in_edge_index(G& graph)
+      -> std::enable_if_t<has_adjacency_container_v<G, Traits> && !is_user_defined_node_type_v<G, Traits> &&
+                          !detail::has_bitset_rows_v<G, Traits>, iterator::transposed_index<G, Traits>>;
+
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+constexpr auto in_edge_index(G& graph)
+      -> std::enable_if_t<detail::has_bitset_rows_v<G, Traits>, iterator::transposed_matrix<G, Traits>>;
 }
 
 #endif //BXLX_GRAPH_INTERFACE_HPP
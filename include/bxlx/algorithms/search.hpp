@@ -8,9 +8,13 @@
 #ifndef BXLX_GRAPH_SEARCH_HPP
 #define BXLX_GRAPH_SEARCH_HPP
 
+#include "bxlx/algorithms/detail/getters.hpp"
 #include "bxlx/algorithms/detail/node_set.hpp"
 #include "constants.hpp"
 
+#include <memory>
+#include <vector>
+
 namespace bxlx::graph {
 
 struct edge_types {
@@ -55,96 +59,206 @@ namespace detail {
   template<class It, class ...Types>
   constexpr static bool can_assign_any = can_assign_with_tup<It, tuple_t<Types...>>;
 
-  template<class It, class Node>
-  using dfs_need_states = std::integral_constant<std::size_t, 2 + (can_assign_any<It, Node, Node, edge_types::reverse_t> ||
-                                                                   can_assign_any<It, Node, Node, edge_types::forward_or_cross_t>)>;
+  // An edge is written with its repr when the output takes it, otherwise with its nodes only.
+  // The in adjacency rows without edge container have no repr, those edges are always written without it.
+  template<class It, class Node, class Repr, class EdgeType>
+  constexpr static bool can_assign_repr = !std::is_same_v<Repr, void*> && can_assign_any<It, Node, Node, Repr, EdgeType>;
+
+  template<class It, class Node, class Repr, class EdgeType>
+  constexpr static bool can_assign_edge = can_assign_repr<It, Node, Repr, EdgeType> || can_assign_any<It, Node, Node, EdgeType>;
+
+  template<class EdgeType, class Node, class It, class Repr>
+  constexpr void assign_edge(It& out, Node const& from, Node const& to, Repr const& repr) {
+    if constexpr (can_assign_repr<It, Node, Repr, EdgeType>) {
+      *out++ = tuple_t<Node, Node, Repr, EdgeType>{from, to, repr, EdgeType{}};
+    } else {
+      *out++ = {from, to, EdgeType{}};
+    }
+  }
+
+  template<class It, class Node, class Repr = void*>
+  using dfs_need_states = std::integral_constant<std::size_t, 2 + (can_assign_edge<It, Node, Repr, edge_types::reverse_t> ||
+                                                                   can_assign_edge<It, Node, Repr, edge_types::forward_or_cross_t>)>;
 
   constexpr std::integral_constant<std::size_t, 0> white {};
   constexpr std::integral_constant<std::size_t, 1> grey {};
   constexpr std::integral_constant<std::size_t, 2> black {};
 }
 
-template<class Dist = size_t, class OutIt,
-          class G, class Traits = graph_traits<G>,
-                class NodeSetT = detail::node_set_t<G, Traits, detail::dfs_need_states<OutIt, node_t<G, Traits>>>,
-                auto* edges_as_neighbours = &with_out_edges>
-constexpr OutIt depth_first_search(G const& g, node_t<G, Traits> from,
-                                   OutIt out, NodeSetT&& nodes = {}, Dist max_dist = ~Dist()) {
-  using NodeSet = std::remove_reference_t<NodeSetT>;
-  constexpr auto recursive = [](auto recursive, G const& g, OutIt& out, NodeSet& nodes, node_t<G, Traits> from, Dist max_dist, Dist distance = 0) -> void {
+namespace detail {
+  // the index is built once per traversal where the in edges of a node would be found by a scan over a matrix
+  // column or over all edges
+  template<class G, class Traits>
+  constexpr bool has_in_edge_index_v = in_edges_cost_v<G, Traits> >= cost_t::nodes &&
+                                       ((has_edge_list_container_v<G, Traits> && is_less_comparable_v<node_t<G, Traits>>) ||
+                                        (has_adjacency_container_v<G, Traits> && !is_user_defined_node_type_v<G, Traits>));
 
-    if constexpr (detail::can_assign_any<OutIt, node_t<G, Traits>, node_types::pre_visit_t, Dist>) {
-      *out++ = detail::tuple_t<node_t<G, Traits>, node_types::pre_visit_t, Dist>{from, node_types::pre_visit_t{}, distance};
+  // Edge lists are grouped once per traversal, the present cells of sparse matrices are indexed by an occupancy bitmap
+  // and adjacency graphs without in edge container are transposed once, so every visited node touches only its own edges.
+  template<class G, class Traits>
+  constexpr auto out_neighbours_of(G const& g) {
+    if constexpr ((out_edges_cost_v<G, Traits> == cost_t::edges && is_less_comparable_v<node_t<G, Traits>>) ||
+                  has_cell_rows_v<G, Traits>) {
+      return out_edge_index(g);
+    } else if constexpr (!has_node_container_v<G, Traits> && has_adjacency_container_v<G, Traits>) {
+      // the shape of a compressed matrix is computed once, not at every visited node
+      return [&g, shape = compressed_matrix_of<G, Traits>(std::size(adjacent_container_getter<const G, Traits>{}(g)))]
+            (node_t<G, Traits> const& from) {
+        return decltype(out_edges(g, from)){g, from, shape};
+      };
+    } else {
+      return [&g] (node_t<G, Traits> const& from) {
+        return out_edges(g, from);
+      };
     }
+  }
 
-    if constexpr (type_traits::range_type_v<NodeSet> == type_traits::range_type_t::set_like) {
-      nodes.insert(from);
+  template<class G, class Traits>
+  constexpr auto in_neighbours_of(G const& g) {
+    if constexpr (has_in_edge_index_v<G, Traits>) {
+      return in_edge_index(g);
     } else {
-      nodes[from] = detail::grey;
+      return [&g] (node_t<G, Traits> const& from) {
+        return in_edges(g, from);
+      };
     }
+  }
 
-    if (max_dist > distance) {
-      for (auto [to, val] : (*edges_as_neighbours)(g, from)) {
-        const auto current_state = [] (NodeSet& nodes, node_t<G, Traits> const& to_node) {
-          if constexpr (type_traits::range_type_v<NodeSet> == type_traits::range_type_t::set_like) {
-            return nodes.count(to_node);
-          } else {
-            return nodes[to_node];
-          }
-        } (nodes, to);
-
-        switch (static_cast<std::size_t>(current_state)) {
-        case detail::white:
-          if constexpr (
-                detail::can_assign_any<OutIt, node_t<G, Traits>, node_t<G, Traits>/*, edge_repr_t<G, Traits>*/, edge_types::tree_t>
-                      ) {
-            *out++ = {from, to/*, val*/, edge_types::tree_t{}};
-          }
-          recursive(recursive, g, out, nodes, to, max_dist, distance + 1);
-          break;
-        case detail::grey:
-          if constexpr (
-                (type_traits::range_type_v<NodeSet> != type_traits::range_type_t::set_like ||
-                 type_traits::is_associative_multi_v<NodeSet>) &&
-                !type_traits::is_bool_v<decltype(current_state)> &&
-                detail::can_assign_any<OutIt, node_t<G, Traits>, node_t<G, Traits>/*, edge_repr_t<G, Traits>*/, edge_types::reverse_t>
-                ) {
-            *out++ = {from, to/*, val*/, edge_types::reverse_t{}};
-          } else if constexpr (
-                detail::can_assign_any<OutIt, node_t<G, Traits>, node_t<G, Traits>/*, edge_repr_t<G, Traits>*/, edge_types::not_tree_t>
-                ) {
-            *out++ = {from, to/*, val*/, edge_types::not_tree_t{}};
-          }
-          break;
-        default:
-          if constexpr (
-                (type_traits::range_type_v<NodeSet> != type_traits::range_type_t::set_like ||
-                 type_traits::is_associative_multi_v<NodeSet>) &&
-                !type_traits::is_bool_v<decltype(current_state)> &&
-                detail::can_assign_any<OutIt, node_t<G, Traits>, node_t<G, Traits>/*, edge_repr_t<G, Traits>*/, edge_types::forward_or_cross_t>) {
-            *out++ = {from, to/*, val*/, edge_types::forward_or_cross_t{}};
-          } else
-          if constexpr (detail::can_assign_any<OutIt, node_t<G, Traits>, node_t<G, Traits>/*, edge_repr_t<G, Traits>*/, edge_types::not_tree_t>) {
-            *out++ = {from, to/*, val*/, edge_types::not_tree_t{}};
-          }
-          continue;
-        }
+  template<class G, class Traits, auto* edges_as_neighbours>
+  constexpr auto neighbours_of(G const& g) {
+    if constexpr (std::is_same_v<decltype(edges_as_neighbours), decltype(&with_out_edges)>) {
+      return out_neighbours_of<G, Traits>(g);
+    } else if constexpr (std::is_same_v<decltype(edges_as_neighbours), decltype(&with_in_edges)>) {
+      return in_neighbours_of<G, Traits>(g);
+    } else if constexpr (std::is_same_v<decltype(edges_as_neighbours), decltype(&with_all_edges)>) {
+      using out_t = decltype(out_neighbours_of<G, Traits>(g)(std::declval<node_t<G, Traits> const&>()));
+      using in_t = decltype(in_neighbours_of<G, Traits>(g)(std::declval<node_t<G, Traits> const&>()));
+      if constexpr (is_less_comparable_v<node_t<G, Traits>> && is_ascending_v<out_t> && is_ascending_v<in_t>) {
+        return [&g, out = out_neighbours_of<G, Traits>(g), in = in_neighbours_of<G, Traits>(g)] (node_t<G, Traits> const& from) {
+          return iterator::merged_edge_iterable<const G, Traits, out_t, in_t>{&g, from, out(from), in(from)};
+        };
+      } else {
+        // one buffer for the whole traversal
+        using buffered_t = iterator::buffered_edge_iterable<const G, Traits>;
+        return [&g, out = out_neighbours_of<G, Traits>(g), in = in_neighbours_of<G, Traits>(g),
+                buffer = std::make_shared<std::vector<typename buffered_t::entry_t>>()] (node_t<G, Traits> const& from) {
+          return buffered_t{g, from, out(from), in(from), buffer.get()};
+        };
       }
+    } else {
+      return [&g] (node_t<G, Traits> const& from) {
+        return (*edges_as_neighbours)(g, from);
+      };
     }
+  }
+
+  // The visited nodes are passed as node_ref_t, so heavy nodes are referenced from the graph, not copied per level.
+  template<class Dist, class OutIt, class G, class Traits, class NodeSet, class Neighbours>
+  constexpr void depth_first_search_impl(node_t<G, Traits> const& from, OutIt& out, NodeSet& nodes,
+                                         Dist max_dist, Neighbours const& neighbours) {
+    constexpr auto recursive = [](auto recursive, OutIt& out, NodeSet& nodes, Neighbours const& neighbours,
+                                  node_ref_t<G, Traits> from, Dist max_dist, Dist distance = 0) -> void {
+
+      if constexpr (can_assign_any<OutIt, node_t<G, Traits>, node_types::pre_visit_t, Dist>) {
+        *out++ = tuple_t<node_t<G, Traits>, node_types::pre_visit_t, Dist>{from, node_types::pre_visit_t{}, distance};
+      }
 
-    if constexpr (type_traits::range_type_v<NodeSet> == type_traits::range_type_t::set_like) {
-      if constexpr (type_traits::is_associative_multi_v<NodeSet>) {
+      if constexpr (type_traits::range_type_v<NodeSet> == type_traits::range_type_t::set_like) {
         nodes.insert(from);
+      } else {
+        nodes[from] = grey;
       }
-    } else {
-      nodes[from] = detail::black;
-    }
 
-    if constexpr (detail::can_assign_any<OutIt, node_t<G, Traits>, node_types::post_visit_t, Dist>) {
-      *out++ = {from, node_types::post_visit_t{}, distance};
-    }
-  };
-  recursive(recursive, g, out, nodes, from, max_dist);
+      if (max_dist > distance) {
+        for (auto [to, val] : neighbours(from)) {
+          using repr_t = std::decay_t<decltype(val)>;
+          const auto current_state = [] (NodeSet& nodes, node_t<G, Traits> const& to_node) {
+            if constexpr (type_traits::range_type_v<NodeSet> == type_traits::range_type_t::set_like) {
+              return nodes.count(to_node);
+            } else {
+              return nodes[to_node];
+            }
+          } (nodes, to);
+
+          switch (static_cast<std::size_t>(current_state)) {
+          case white:
+            if constexpr (
+                  can_assign_edge<OutIt, node_t<G, Traits>, repr_t, edge_types::tree_t>
+                        ) {
+              assign_edge<edge_types::tree_t, node_t<G, Traits>>(out, from, to, val);
+            }
+            recursive(recursive, out, nodes, neighbours, to, max_dist, distance + 1);
+            break;
+          case grey:
+            if constexpr (
+                  (type_traits::range_type_v<NodeSet> != type_traits::range_type_t::set_like ||
+                   type_traits::is_associative_multi_v<NodeSet>) &&
+                  !type_traits::is_bool_v<decltype(current_state)> &&
+                  can_assign_edge<OutIt, node_t<G, Traits>, repr_t, edge_types::reverse_t>
+                  ) {
+              assign_edge<edge_types::reverse_t, node_t<G, Traits>>(out, from, to, val);
+            } else if constexpr (
+                  can_assign_edge<OutIt, node_t<G, Traits>, repr_t, edge_types::not_tree_t>
+                  ) {
+              assign_edge<edge_types::not_tree_t, node_t<G, Traits>>(out, from, to, val);
+            }
+            break;
+          default:
+            if constexpr (
+                  (type_traits::range_type_v<NodeSet> != type_traits::range_type_t::set_like ||
+                   type_traits::is_associative_multi_v<NodeSet>) &&
+                  !type_traits::is_bool_v<decltype(current_state)> &&
+                  can_assign_edge<OutIt, node_t<G, Traits>, repr_t, edge_types::forward_or_cross_t>) {
+              assign_edge<edge_types::forward_or_cross_t, node_t<G, Traits>>(out, from, to, val);
+            } else
+            if constexpr (can_assign_edge<OutIt, node_t<G, Traits>, repr_t, edge_types::not_tree_t>) {
+              assign_edge<edge_types::not_tree_t, node_t<G, Traits>>(out, from, to, val);
+            }
+            continue;
+          }
+        }
+      }
+
+      if constexpr (type_traits::range_type_v<NodeSet> == type_traits::range_type_t::set_like) {
+        if constexpr (type_traits::is_associative_multi_v<NodeSet>) {
+          nodes.insert(from);
+        }
+      } else {
+        nodes[from] = black;
+      }
+
+      if constexpr (can_assign_any<OutIt, node_t<G, Traits>, node_types::post_visit_t, Dist>) {
+        *out++ = {from, node_types::post_visit_t{}, distance};
+      }
+    };
+    recursive(recursive, out, nodes, neighbours, from, max_dist);
+  }
+}
+
+// Visited nodes which are reused by repeated traversals over the same index graph. Pass it as the node set and call
+// clear() before the next traversal, which is O(1). The default node set of user defined nodes is a hash set, which
+// can be reused the same way, but its clear() is linear in its capacity.
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+using reusable_node_set_t = std::enable_if_t<!is_user_defined_node_type_v<G, Traits>,
+                                             detail::epoch_node_set<node_t<G, Traits>, 3>>;
+
+// Visited nodes shared by the threads of a parallel traversal: an atomic bitset of index nodes, or a fixed capacity
+// hash set of user defined nodes. Size it with resize_nodes(node_count(g)) before the threads start, then claim(node)
+// returns true for exactly one thread per node.
+template<class G, class Traits = graph_traits<G>, bool = it_is_a_graph_v<G, Traits>>
+using concurrent_node_set_t = std::conditional_t<is_user_defined_node_type_v<G, Traits>,
+                                                 detail::concurrent_hash_node_set<node_t<G, Traits>>,
+                                                 detail::atomic_node_set<node_t<G, Traits>>>;
+
+template<class Dist = size_t, class OutIt,
+          class G, class Traits = graph_traits<G>,
+                class NodeSetT = detail::node_set_t<G, Traits, detail::dfs_need_states<OutIt, node_t<G, Traits>, edge_repr_t<const G, Traits>>>,
+                auto* edges_as_neighbours = &with_out_edges>
+constexpr OutIt depth_first_search(G const& g, node_t<G, Traits> from,
+                                   OutIt out, NodeSetT&& nodes = {}, Dist max_dist = ~Dist()) {
+  detail::init_node_set<G, Traits>(g, nodes);
+  detail::depth_first_search_impl<Dist, OutIt, G, Traits>(from, out, nodes, max_dist,
+                                                          detail::neighbours_of<G, Traits, edges_as_neighbours>(g));
   return out;
 }
 
@@ -8,6 +8,7 @@
 #ifndef BXLX_GRAPH_SORT_HPP
 #define BXLX_GRAPH_SORT_HPP
 #include "bxlx/algorithms/detail/getters.hpp"
+#include "search.hpp"
 
 #include <sstream>
 
@@ -50,16 +51,18 @@ constexpr OutIt topological_sort(
     }
   } out_it{it};
 
-  for (node_t<G, Traits> node : node_indices(g)) {
+  detail::init_node_set<G, Traits>(g, nodes);
+  const auto neighbours = detail::neighbours_of<G, Traits, &with_out_edges>(g);
+  for (node_t<G, Traits> const& node : node_indices(g)) {
     const auto current_state = [] (NodeSet& nodes, node_t<G, Traits> const& to_node) {
-      if constexpr (type_traits::range_type_v<NodeSet> == type_traits::range_type_t::set_like) {
+      if constexpr (type_traits::range_type_v<std::remove_reference_t<NodeSet>> == type_traits::range_type_t::set_like) {
         return nodes.count(to_node);
       } else {
         return nodes[to_node];
       }
     } (nodes, node);
     if (current_state == detail::white) {
-      depth_first_search(g, node, out_it, nodes);
+      detail::depth_first_search_impl<std::size_t, out_it_t, G, Traits>(node, out_it, nodes, ~std::size_t{}, neighbours);
     }
   }
   return out;
@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2022-2023 Bela Schaum (schaumb at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "femto_test.hpp"
+#include <bxlx/graph>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST(check_csr_from_adj_list) {
+  using namespace bxlx::graph;
+  const std::vector<std::vector<int>> g{{1, 2}, {2}, {}};
+
+  auto c = make_csr(g);
+  S_ASSERT(representation_v<decltype(c)> == representation_t::adjacency_list);
+  SAME(node_t<decltype(c)>, int);
+
+  ASSERT(node_count(c) == 3);
+  ASSERT(c.edge_size() == 3);
+  ASSERT(c.offsets(1) == 2 && c.offsets(2) == 3 && c.offsets(3) == 3);
+  ASSERT(has_edge(c, 0, 2) && !has_edge(c, 2, 0));
+
+  auto copy = c;
+  ASSERT(std::begin(copy.row(0)) != std::begin(c.row(0)));
+  ASSERT(has_edge(copy, 1, 2) && out_edges(copy, 0).size() == 2);
+
+  ASSERT(node_count(make_csr(std::vector<std::vector<int>>{})) == 0);
+}
+
+TEST(check_csr_from_edge_list) {
+  using namespace bxlx::graph;
+  const std::pair<std::string, std::string> g[]{{"b", "c"}, {"a", "b"}, {"a", "c"}};
+
+  auto c = make_csr<unsigned>(g);
+  SAME(node_t<decltype(c)>, unsigned);
+
+  ASSERT(node_count(c) == 3);
+  ASSERT(c.key(0) == "a" && c.index_of("c") == 2);
+  ASSERT(out_edges(c, c.index_of("a")).size() == 2);
+
+  std::vector<unsigned> order(3);
+  topological_sort(c, order.begin());
+  ASSERT(order == std::vector<unsigned>{0, 1, 2});
+}
+
+TEST(check_csr_properties) {
+  using namespace bxlx::graph;
+  const std::vector<std::pair<std::vector<std::pair<int, double>>, float>> g{{{{1, 0.5}}, 1.5f}, {{}, 2.5f}};
+
+  auto c = make_csr(g);
+  S_ASSERT(has_edge_property_v<decltype(c)> && has_node_property_v<decltype(c)>);
+  ASSERT(edge_property(c, 0, 1) == 0.5);
+  ASSERT(node_property(c, 1) == 2.5f);
+
+  const auto& cc = c;
+  SAME(decltype(cc.edge_property(0)), const double&);
+  ASSERT(cc.edge_property(cc.offsets(0)) == 0.5);
+}
@@ -6,19 +6,562 @@
 //
 
 #include "femto_test.hpp"
+#include <bxlx/graph>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 TEST(check_node_indices) {
+  using namespace bxlx::graph;
+  const std::pair<std::string, std::string> g[]{{"b", "c"}, {"a", "b"}, {"c", "a"}, {"d", "d"}};
 
+  std::vector<std::string> nodes;
+  for (auto&& n : node_indices(g))
+    nodes.push_back(n);
+  ASSERT(nodes == std::vector<std::string>{"a", "b", "c", "d"});
+  ASSERT(node_count(g) == 4);
+  ASSERT(node_count(g, [] (std::string const& l, std::string const& r) { return l == r; }) == 4);
 }
 
 TEST(check_out_edges) {
+  using namespace bxlx::graph;
+  const std::pair<int, int> g[]{{1, 2}, {0, 1}, {1, 3}, {0, 2}};
 
+  const auto index = out_edge_index(g);
+  std::vector<int> targets;
+  for (auto [to, repr] : index(1))
+    targets.push_back(to);
+  ASSERT(targets == std::vector<int>{2, 3});
+  ASSERT(index(0).size() == out_edges(g, 0).size());
+  ASSERT(index(3).size() == 0);
+
+  const std::set<std::pair<int, int>> ordered{{-1, 2}, {0, -3}, {0, -1}, {0, 4}, {1, 0}};
+  targets.clear();
+  for (auto [to, repr] : out_edges(ordered, 0))
+    targets.push_back(to);
+  ASSERT(targets == std::vector<int>{-3, -1, 4});
+  ASSERT(out_edges(ordered, -1).size() == 1 && out_edges(ordered, 2).size() == 0);
+
+  const std::map<std::pair<int, int>, double> weighted{{{0, 1}, .5}, {{1, 2}, 1.}, {{1, 3}, 2.}};
+  targets.clear();
+  for (auto [to, repr] : out_edges(weighted, 1))
+    targets.push_back(to);
+  ASSERT(targets == std::vector<int>{2, 3});
+
+  std::vector<std::bitset<130>> m(130);
+  std::vector<std::vector<bool>> vm(130, std::vector<bool>(130));
+  for (std::size_t to : {0, 63, 64, 127, 129})
+    m[1][to] = vm[1][to] = true;
+
+  std::vector<std::size_t> bits, vbits;
+  for (auto [to, repr] : out_edges(m, 1))
+    bits.push_back(to);
+  for (auto [to, repr] : out_edges(vm, 1))
+    vbits.push_back(to);
+  ASSERT(bits == std::vector<std::size_t>{0, 63, 64, 127, 129});
+  ASSERT(vbits == bits);
+  ASSERT(out_edges(m, 2).size() == 0);
+
+  std::bitset<16> cm;
+  cm[1*4+1] = cm[1*4+3] = cm[3*4+0] = true;
+  bits.clear();
+  for (auto [to, repr] : out_edges(cm, 1))
+    bits.push_back(to);
+  ASSERT(bits == std::vector<std::size_t>{1, 3});
+  ASSERT(edge_count(cm) == 3);
+  ASSERT(out_degree(cm, 1) == 2 && out_degree(cm, 2) == 0);
+  ASSERT(in_degree(cm, 1) == 1 && in_degree(cm, 0) == 1);
+  std::bitset<100> wm;
+  wm[1*10+0] = wm[1*10+9] = wm[7*10+1] = true;
+  ASSERT(edge_count(wm) == 3 && out_degree(wm, 1) == 2 && out_degree(wm, 7) == 1 && out_degree(wm, 0) == 0);
+  S_ASSERT(detail::compressed_matrix_of<std::bitset<16>, graph_traits<std::bitset<16>>>(0).k == 4);
+  constexpr std::bitset<40> sparse{0x8000000048ull};
+  S_ASSERT(detail::find_next_set(sparse, 4, 40) == 6 && detail::count_set(sparse, 0, 40) == 3);
+  ASSERT(detail::find_next_set(sparse, 7, 40) == 39 && detail::count_set(sparse, 4, 39) == 1);
+  ASSERT(detail::read_bits(sparse, 3, 40) == (0x8000000048ull >> 3));
+  std::vector<bool> dm(16);
+  dm[1*4+3] = dm[2*4+3] = true;
+  const auto shape = detail::compressed_matrix_of<std::vector<bool>, graph_traits<std::vector<bool>>>(dm.size());
+  ASSERT(shape.k == 4 && shape.layout == detail::compressed_layout::square);
+  ASSERT((iterator::edge_iterable<std::vector<bool>, graph_traits<std::vector<bool>>>{dm, 2, shape}.size()) == 1);
+
+  // 4 nodes without the diagonal: 0->3, 2->0, 2->1, 3->2
+  std::bitset<12> nm;
+  nm[0*3+2] = nm[2*3+0] = nm[2*3+1] = nm[3*3+2] = true;
+  bits.clear();
+  for (auto [to, repr] : out_edges(nm, 2))
+    bits.push_back(to);
+  ASSERT(bits == std::vector<std::size_t>{0, 1});
+  ASSERT(node_count(nm) == 4 && out_edges(nm, 3).size() == 1 && (*out_edges(nm, 0).begin()).first == 3);
+  ASSERT(out_degree(nm, 2) == 2 && in_degree(nm, 2) == 1 && in_degree(nm, 3) == 1);
+  ASSERT(get_edge(nm, 2, 2) == invalid_edge(nm) && get_edge(nm, 3, 2) != invalid_edge(nm));
+
+  // 5 nodes of an undirected graph in the lower triangle: {0, 3}, {1, 2}, {2, 4}, {3, 4}
+  std::bitset<10> tm;
+  tm[3*2/2+0] = tm[2*1/2+1] = tm[4*3/2+2] = tm[4*3/2+3] = true;
+  bits.clear();
+  for (auto [to, repr] : out_edges(tm, 2))
+    bits.push_back(to);
+  ASSERT(bits == std::vector<std::size_t>{1, 4});
+  bits.clear();
+  for (auto [to, repr] : out_edges(tm, 0))
+    bits.push_back(to);
+  ASSERT(bits == std::vector<std::size_t>{3});
+  ASSERT(node_count(tm) == 5 && edge_count(tm) == 4 && out_edges(tm, 3).size() == 2);
+  ASSERT(out_degree(tm, 3) == 2 && in_degree(tm, 4) == 2 && out_degree(tm, 1) == 1);
+  ASSERT(get_edge(tm, 0, 3) == get_edge(tm, 3, 0) && get_edge(tm, 0, 3) != invalid_edge(tm));
+  ASSERT(get_edge(tm, 1, 1) == invalid_edge(tm) && get_edge(tm, 0, 1) == invalid_edge(tm));
+
+  ASSERT(edge_count(m) == 5 && edge_count(vm) == 5);
+  ASSERT(out_degree(m, 1) == 5 && out_degree(vm, 1) == 5);
+  ASSERT(in_degree(m, 64) == 1 && in_degree(vm, 2) == 0);
 }
 
 TEST(check_in_edges) {
+  using namespace bxlx::graph;
+  const std::pair<int, int> g[]{{1, 2}, {0, 1}, {1, 3}, {0, 2}};
+
+  const auto index = in_edge_index(g);
+  std::vector<int> sources;
+  for (auto [from, repr] : index(2))
+    sources.push_back(from);
+  ASSERT(sources == std::vector<int>{1, 0});
+  ASSERT(index(1).size() == in_edges(g, 1).size());
+
+  const std::vector<std::vector<int>> adj{{1, 2}, {2, 3}, {}, {2}};
+  const auto transposed = in_edge_index(adj);
+  sources.clear();
+  for (auto [from, repr] : transposed(2))
+    sources.push_back(from);
+  ASSERT(sources == std::vector<int>{0, 1, 3});
+  for (auto [from, repr] : transposed(2))
+    ASSERT(repr == get_edge(adj, from, 2));
+  ASSERT(transposed(0).size() == 0 && in_edges(adj, 0).size() == 0);
+  ASSERT(in_edges(adj, 2).size() == 3);
+  sources.clear();
+  for (auto [from, repr] : in_edges(adj, 2))
+    sources.push_back(from);
+  ASSERT(sources == std::vector<int>{0, 1, 3});
+
+  const std::map<std::string, std::vector<std::string>> named{{"a", {"b", "c", "b"}}, {"b", {}}, {"c", {"b"}}};
+  std::vector<std::string> named_sources;
+  for (auto [from, repr] : in_edges(named, "b")) {
+    ASSERT(*repr == "b" && &from == &named.find(from)->first);
+    named_sources.push_back(from);
+  }
+  ASSERT(named_sources == std::vector<std::string>{"a", "a", "c"} && in_edges(named, "a").size() == 0);
+
+  std::vector<std::bitset<130>> m(130);
+  for (std::size_t from : {0, 63, 64, 127, 129})
+    m[from][100] = true;
+  m[5][3] = true;
+  std::vector<std::size_t> bits, tbits;
+  for (auto [from, repr] : in_edges(m, 100))
+    bits.push_back(from);
+  const auto tm = in_edge_index(m);
+  for (auto [from, repr] : tm(100))
+    tbits.push_back(from);
+  ASSERT(bits == std::vector<std::size_t>{0, 63, 64, 127, 129});
+  ASSERT(tbits == bits && tm(3).size() == 1 && tm(5).size() == 0);
+  for (auto [from, repr] : tm(100))
+    ASSERT(repr == get_edge(m, from, 100) && *repr);
+
+  std::bitset<16> cm;
+  cm[1*4+1] = cm[1*4+3] = cm[3*4+3] = cm[2*4+3] = true;
+  bits.clear();
+  for (auto [from, repr] : in_edges(cm, 3))
+    bits.push_back(from);
+  ASSERT(bits == std::vector<std::size_t>{1, 2, 3} && in_edges(cm, 0).size() == 0);
+  ASSERT(in_edge_index(cm)(3).size() == 3 && in_edge_index(cm)(1).size() == 1);
+  const auto tcm = in_edge_index(cm);
+  for (auto [from, repr] : tcm(3))
+    ASSERT(repr == get_edge(cm, from, 3) && *repr);
+
+  // undirected lower triangle of 5 nodes: {0, 3}, {1, 2}, {2, 4}, {3, 4}
+  std::bitset<10> t;
+  t[3*2/2+0] = t[2*1/2+1] = t[4*3/2+2] = t[4*3/2+3] = true;
+  bits.clear();
+  const auto tt = in_edge_index(t);
+  for (auto [from, repr] : tt(4))
+    bits.push_back(from);
+  ASSERT(bits == std::vector<std::size_t>{2, 3} && in_edges(t, 2).size() == 2);
+}
+
+TEST(check_matrix_cells) {
+  using namespace bxlx::graph;
+  std::vector<std::vector<std::optional<double>>> g(100, std::vector<std::optional<double>>(100));
+  g[1][2] = .5;
+  g[1][70] = 1.5;
+  g[3][1] = 2.;
+
+  std::vector<std::size_t> targets;
+  for (auto [to, repr] : out_edges(g, 1))
+    targets.push_back(to);
+  ASSERT(targets == std::vector<std::size_t>{2, 70});
+  ASSERT(edge_count(g) == 3 && out_degree(g, 0) == 0);
+  ASSERT(edge_property(g, 1, 70) == 1.5 && get_edge(g, 1, 3) == invalid_edge(g));
+
+  auto occupancy = out_edge_index(g);
+  double sum{};
+  for (auto [to, repr] : occupancy(1))
+    sum += edge_property(g, repr);
+  ASSERT(sum == 2. && occupancy.edge_count() == 3 && occupancy(3).size() == 1);
+
+  g[1][2].reset();
+  g[0][99] = 3.;
+  occupancy.update(1, 2);
+  occupancy.update(0, 99);
+  ASSERT(occupancy(1).size() == 1 && (*occupancy(0).begin()).first == 99 && occupancy.edge_count() == 3);
+
+  std::vector<std::vector<std::vector<int>>> multi(3, std::vector<std::vector<int>>(3));
+  multi[0][2] = {1, 2};
+  ASSERT(out_edges(multi, 0).size() == 1 && (*out_edges(multi, 0).begin()).first == 2);
+}
 
+namespace {
+// A depth first search with the given node set, or with the default one, visits the same nodes in the same order as
+// with a std::set. An lvalue node set is filled by the call, so it is not called in an ASSERT.
+template<class G, class... NodeSet>
+bool visits_as_with_std_set(G const& g, bxlx::graph::node_t<G> const& from, NodeSet&&... nodes) {
+  using namespace bxlx::graph;
+  std::vector<std::tuple<node_t<G>, node_types::pre_visit_t, std::size_t>> expected, visits;
+  depth_first_search(g, from, std::back_inserter(expected), std::set<node_t<G>>{});
+  depth_first_search(g, from, std::back_inserter(visits), std::forward<NodeSet>(nodes)...);
+  return !expected.empty() && visits == expected;
+}
+}
+
+TEST(check_packed_node_sets) {
+  using namespace bxlx::graph;
+  const bool m[5][5]{{0, 1, 1, 0, 0}, {0, 0, 0, 1, 0}, {0, 0, 0, 1, 0}, {0, 0, 0, 0, 1}, {}};
+  const std::array<std::vector<int>, 5> a{{{1, 2}, {3}, {3}, {4}, {}}};
+  const std::vector<std::vector<int>> v{{1, 2}, {3}, {3}, {4}, {}};
+
+  using two_states = detail::node_set_t<decltype(m)>;
+  using three_states = detail::node_set_t<decltype(a), graph_traits<decltype(a)>, std::integral_constant<std::size_t, 3>>;
+  S_ASSERT(detail::has_bitset_words_v<two_states> && sizeof(two_states) == sizeof(std::uint64_t));
+  S_ASSERT(!detail::has_bitset_words_v<three_states> && three_states::USED_BITS_PER_NODE == 2);
+  S_ASSERT(std::is_same_v<detail::node_set_t<std::map<std::pair<int, int>, std::vector<std::pair<int, int>>>>,
+                          std::set<std::pair<int, int>>>);
+
+  three_states colours{};
+  colours[3] = detail::black;
+  colours[0] = detail::grey;
+  colours[2] = detail::grey;
+  colours[2] = detail::white;
+  std::vector<std::size_t> visited;
+  for (auto it = colours.begin(); it != colours.end(); ++it)
+    visited.push_back(it.index);
+  ASSERT(visited == std::vector<std::size_t>{0, 3} && colours[3] == 2 && colours[0] == 1);
+
+  ASSERT(visits_as_with_std_set(m, 0) && visits_as_with_std_set(a, 0) && visits_as_with_std_set(v, 0));
+
+  std::vector<int> order(5), matrix_order(5), dense_order(5);
+  topological_sort(v, order.begin(), std::multiset<int>{});
+  topological_sort(m, matrix_order.begin());
+  topological_sort(v, dense_order.begin());
+  ASSERT(order == matrix_order && order == dense_order);
+}
+
+TEST(check_dense_node_sets) {
+  using namespace bxlx::graph;
+  std::vector<std::vector<int>> g(200);
+  for (int i = 0; i + 1 < 200; ++i)
+    g[i].push_back(i + 1);
+  g[150].push_back(10);
+
+  using dense_t = detail::node_set_t<decltype(g), graph_traits<decltype(g)>, std::integral_constant<std::size_t, 3>>;
+  S_ASSERT(detail::is_dynamic_node_set_v<dense_t> && dense_t::USED_BITS_PER_NODE == 2);
+
+  dense_t colours{};
+  std::vector<std::tuple<int, int, edge_types::reverse_t>> reverse;
+  depth_first_search(g, 0, std::back_inserter(reverse), colours);
+  ASSERT(colours.size() == 200 && colours[199] == 2);
+  ASSERT(reverse.size() == 1 && std::get<0>(reverse[0]) == 150 && std::get<1>(reverse[0]) == 10);
+
+  std::size_t black{};
+  for (auto it = colours.begin(); it != colours.end(); ++it)
+    black += colours[it.index] == 2;
+  ASSERT(black == 200);
+
+  // an already sized set keeps its states, so the nodes visited before are skipped
+  std::vector<std::tuple<int, node_types::pre_visit_t, std::size_t>> visits;
+  depth_first_search(g, 0, std::back_inserter(visits), colours);
+  ASSERT(visits.size() == 1);
+}
+
+namespace {
+template<class G, class = void>
+constexpr bool has_reusable_node_set_v = false;
+
+template<class G>
+constexpr bool has_reusable_node_set_v<G, std::void_t<bxlx::graph::reusable_node_set_t<G>>> = true;
+}
+
+TEST(check_reusable_node_sets) {
+  using namespace bxlx::graph;
+  const std::vector<std::vector<int>> g{{1, 2}, {3}, {3}, {4}, {}};
+  S_ASSERT(has_reusable_node_set_v<decltype(g)>);
+  S_ASSERT(!has_reusable_node_set_v<std::map<std::string, std::vector<std::string>>>);
+
+  std::vector<std::tuple<int, int, edge_type>> expected, edges;
+  depth_first_search(g, 0, std::back_inserter(expected));
+
+  reusable_node_set_t<decltype(g)> nodes;
+  for (int i = 0; i < 3; ++i) {
+    nodes.clear();
+    edges.clear();
+    depth_first_search(g, 0, std::back_inserter(edges), nodes);
+    ASSERT(edges == expected && nodes.size() == 5 && nodes[4] == 2);
+  }
+
+  std::vector<int> order(5), reused_order(5);
+  topological_sort(g, order.begin());
+  nodes.clear();
+  topological_sort(g, reused_order.begin(), nodes);
+  ASSERT(order == reused_order);
+
+  // the stamps are rewritten when the epoch wraps around
+  nodes.epoch = std::numeric_limits<std::uint32_t>::max() - 3;
+  nodes[1] = detail::black;
+  nodes.clear();
+  ASSERT(nodes.epoch == 0 && nodes[1] == 0 && nodes.begin() == nodes.end());
+}
+
+TEST(check_hash_node_sets) {
+  using namespace bxlx::graph;
+  const std::map<std::string, std::vector<std::string>> g{{"a", {"b", "c"}}, {"b", {"d"}}, {"c", {"d"}}, {"d", {}}};
+  const std::vector<std::pair<int, int>> el{{5, 7}, {7, 9}, {5, 9}, {9, 100}};
+
+  using colours_t = detail::node_set_t<decltype(g), graph_traits<decltype(g)>, std::integral_constant<std::size_t, 3>>;
+  S_ASSERT(std::is_same_v<colours_t, detail::hash_node_set<std::string, 3>>);
+  S_ASSERT(std::is_same_v<detail::node_set_t<decltype(el)>, detail::hash_node_set<int, 2>>);
+
+  colours_t colours{};
+  colours["c"] = detail::black;
+  colours["a"] = detail::grey;
+  colours["b"] = detail::grey;
+  colours["b"] = detail::white;
+  std::set<std::string> visited(colours.begin(), colours.end());
+  ASSERT(visited == std::set<std::string>{"a", "c"} && colours["c"] == 2 && colours["a"] == 1 && colours["d"] == 0);
+
+  // the states are kept while the table grows
+  for (int i = 0; i < 100; ++i)
+    colours[std::to_string(i)] = detail::grey;
+  ASSERT(std::distance(colours.begin(), colours.end()) == 102 && colours["c"] == 2 && colours["42"] == 1 && colours["b"] == 0);
+
+  // the reference keeps its node, not the address of the operator[] argument
+  auto later = colours[std::string{"later"}];
+  later = detail::grey;
+  ASSERT(colours["later"] == 1);
+
+  ASSERT(visits_as_with_std_set(g, "a"));
+
+  // a cleared set is reused by the next traversal
+  colours.clear();
+  ASSERT(colours.begin() == colours.end() && colours["c"] == 0);
+  const bool reused = visits_as_with_std_set(g, "a", colours);
+  ASSERT(reused);
+
+  std::vector<std::string> order(4), hash_order(4);
+  topological_sort(g, order.begin(), std::multiset<std::string>{});
+  topological_sort(g, hash_order.begin());
+  ASSERT(order == hash_order);
+
+  ASSERT(visits_as_with_std_set(el, 5));
+}
+
+TEST(check_concurrent_node_sets) {
+  using namespace bxlx::graph;
+  std::vector<std::vector<int>> g(1000);
+  std::map<std::string, std::vector<std::string>> named;
+  for (int i = 0; i < 1000; ++i) {
+    g[i].push_back((i + 1) % 1000);
+    named[std::to_string(i)].push_back(std::to_string((i + 1) % 1000));
+  }
+
+  concurrent_node_set_t<decltype(g)> bits;
+  concurrent_node_set_t<decltype(named)> hashed;
+  S_ASSERT(std::is_same_v<decltype(bits), detail::atomic_node_set<int>>);
+  S_ASSERT(std::is_same_v<decltype(hashed), detail::concurrent_hash_node_set<std::string>>);
+  bits.resize_nodes(node_count(g));
+  hashed.resize_nodes(node_count(named));
+
+  // every node is claimed by exactly one thread
+  std::atomic<std::size_t> claimed_bits{}, claimed_hashed{};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 1000; ++i) {
+        const int node = (i * 7 + t * 250) % 1000;
+        claimed_bits += bits.claim(node);
+        claimed_hashed += hashed.claim(std::to_string(node));
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  ASSERT(claimed_bits == 1000 && claimed_hashed == 1000);
+  ASSERT(bits[999] && hashed[std::string{"999"}] && !hashed[std::string{"1000"}]);
+  const bool claimed_again = hashed.claim("42");
+  ASSERT(std::distance(hashed.begin(), hashed.end()) == 1000 && !claimed_again);
+
+  // the claimed nodes are kept, and the resized set takes the new ones
+  hashed.resize_nodes(5000);
+  std::size_t claimed_new{};
+  for (int i = 1000; i < 5000; ++i)
+    claimed_new += hashed.claim(std::to_string(i));
+  ASSERT(claimed_new == 4000 && std::distance(hashed.begin(), hashed.end()) == 5000 && hashed[std::string{"999"}]);
+  auto later = hashed[std::string{"later"}];
+  later = true;
+  ASSERT(hashed[std::string{"later"}]);
+
+  ASSERT(visits_as_with_std_set(g, 0, concurrent_node_set_t<decltype(g)>{}));
 }
 
 TEST(check_neighbours) {
+  using namespace bxlx::graph;
+  const std::vector<std::vector<int>> g{{1, 2}, {2}, {0, 1}, {2}};
+
+  std::vector<int> neighbours;
+  for (auto [n, repr] : in_out_edges(g, 2))
+    neighbours.push_back(n);
+  ASSERT(neighbours == std::vector<int>{0, 1, 3});
+  ASSERT(in_out_edges(g, 3).size() == 1);
+  // the out edge is kept for a neighbour in both directions
+  for (auto [n, repr] : in_out_edges(g, 2))
+    ASSERT(repr == (n == 3 ? get_edge(g, 3, 2) : get_edge(g, 2, n)));
+
+  std::vector<std::tuple<int, int, std::vector<int>::const_iterator, edge_types::tree_t>> tree;
+  std::vector<std::tuple<int, int, edge_types::not_tree_t>> not_tree;
+  depth_first_search(g, 0, std::back_inserter(tree));
+  depth_first_search(g, 0, std::back_inserter(not_tree));
+  ASSERT(tree.size() == 2 && not_tree.size() == 3);
+  for (auto [from, to, repr, type] : tree)
+    ASSERT(repr == get_edge(g, from, to));
+
+  // ascending rows are merged while iterating, the others are collected into a buffer
+  const std::vector<std::set<int>> sets{{1, 3}, {}, {1}, {2}};
+  const std::vector<std::vector<int>> rows{{3, 1, 1}, {}, {1}, {2}};
+  S_ASSERT(detail::is_ascending_v<decltype(out_edges(sets, 0))> && !detail::is_ascending_v<decltype(out_edges(rows, 0))>);
+  neighbours.clear();
+  for (auto [n, repr] : in_out_edges(sets, 1))
+    neighbours.push_back(n);
+  ASSERT(neighbours == std::vector<int>{0, 2} && in_out_edges(sets, 3).size() == 2);
+  for (auto [n, repr] : in_out_edges(sets, 3))
+    ASSERT(repr == (n == 0 ? get_edge(sets, 0, 3) : get_edge(sets, 3, n)));
+  neighbours.clear();
+  for (auto [n, repr] : in_out_edges(rows, 0))
+    neighbours.push_back(n);
+  ASSERT(neighbours == std::vector<int>{1, 3});
+
+  // 2 and 3 are reached only through in edges, the nested steps stack their neighbours on the parent's
+  using visit_t = std::tuple<int, node_types::pre_visit_t, std::size_t>;
+  std::vector<visit_t> by_sets, by_rows;
+  depth_first_search<std::size_t, decltype(std::back_inserter(by_sets)), decltype(sets), graph_traits<decltype(sets)>,
+                     std::set<int>, &with_all_edges>(sets, 0, std::back_inserter(by_sets));
+  depth_first_search<std::size_t, decltype(std::back_inserter(by_rows)), decltype(rows), graph_traits<decltype(rows)>,
+                     std::set<int>, &with_all_edges>(rows, 0, std::back_inserter(by_rows));
+  const std::vector<visit_t> expected{{0, {}, 0}, {1, {}, 1}, {2, {}, 2}, {3, {}, 3}};
+  ASSERT(by_sets == expected && by_rows == expected);
+}
+
+namespace {
+struct point {
+  int x, y;
+
+  bool operator<(point const& rhs) const {
+    return std::tie(x, y) < std::tie(rhs.x, rhs.y);
+  }
+
+  bool operator==(point const& rhs) const {
+    return x == rhs.x && y == rhs.y;
+  }
+};
+}
+
+TEST(check_degrees) {
+  using namespace bxlx::graph;
+  const std::vector<std::vector<int>> g{{1, 2}, {2}, {0, 1}, {2}};
+
+  ASSERT(out_degree(g, 0) == 2 && out_degree(g, 3) == 1);
+  ASSERT(in_degree(g, 2) == 3 && in_degree(g, 3) == 0);
+  ASSERT(out_degrees(g) == std::vector<std::size_t>{2, 1, 2, 1});
+  ASSERT(in_degrees(g) == std::vector<std::size_t>{1, 2, 3, 0});
+
+  const std::pair<std::string, std::string> el[]{{"a", "b"}, {"a", "c"}, {"c", "b"}};
+  auto outs = out_degrees(el);
+  auto ins = in_degrees(el);
+  ASSERT(outs.size() == 3 && outs["a"] == 2 && outs["b"] == 0 && outs["c"] == 1);
+  ASSERT(ins.size() == 3 && ins["a"] == 0 && ins["b"] == 2 && ins["c"] == 1);
+  ASSERT(out_degree(el, "a") == 2 && in_degree(el, "b") == 2);
+  S_ASSERT(std::is_same_v<decltype(ins), detail::hash_node_map<std::string, std::size_t>>);
+
+  const std::vector<std::pair<int, int>> sparse{{5, 1000000}, {5, 7}, {7, 1000000}};
+  const auto sparse_ins = in_degrees(sparse);
+  ASSERT(sparse_ins.size() == 3 && sparse_ins.at(1000000) == 2 && sparse_ins.at(5) == 0 && sparse_ins.count(6) == 0);
+  std::size_t sum{};
+  for (auto&& [node, degree] : sparse_ins)
+    sum += degree;
+  ASSERT(sum == sparse.size());
+
+  // without std::hash the degrees are ordered by the node
+  const std::map<point, std::set<point>> grid{{{0, 0}, {{0, 1}}}, {{0, 1}, {{1, 1}}}, {{1, 1}, {}}};
+  const auto grid_ins = in_degrees(grid);
+  S_ASSERT(std::is_same_v<decltype(grid_ins), const std::map<point, std::size_t>>);
+  ASSERT(grid_ins.size() == 3 && grid_ins.at({0, 0}) == 0 && grid_ins.at({1, 1}) == 1);
+}
+
+TEST(check_edge_reprs) {
+  using namespace bxlx::graph;
+  const std::vector<std::vector<std::pair<int, double>>> g{{{1, .5}, {2, 1.5}}, {{2, 2.}}, {}};
+
+  double sum{};
+  for (auto [to, repr] : out_edges(g, 0))
+    sum += edge_property(g, repr);
+  ASSERT(sum == 2.);
+  for (auto [from, repr] : in_edges(g, 2))
+    ASSERT(repr == get_edge(g, from, 2));
+
+  const std::vector<std::tuple<int, int, double>> el{{0, 1, .5}, {1, 2, 2.}, {0, 2, 1.5}};
+  sum = 0;
+  for (auto [to, repr] : out_edges(el, 0))
+    sum += edge_property(el, repr);
+  ASSERT(sum == 2.);
+  const auto index = in_edge_index(el);
+  for (auto [from, repr] : index(2))
+    ASSERT(edge_property(el, repr) == (from == 0 ? 1.5 : 2.));
+
+  std::vector<std::bitset<8>> m(8);
+  m[1][5] = true;
+  for (auto [to, repr] : out_edges(m, 1))
+    ASSERT(to == 5 && repr == get_edge(m, 1, 5));
+}
+
+TEST(check_node_references) {
+  using namespace bxlx::graph;
+  const std::vector<std::pair<std::string, std::string>> g{{"a", "b"}, {"a", "c"}, {"c", "b"}};
+
+  for (auto [to, repr] : out_edges(g, "a"))
+    ASSERT(&to == &repr->second);
+  for (auto [from, repr] : in_edges(g, "b"))
+    ASSERT(&from == &repr->first);
+  for (auto&& n : node_indices(g))
+    ASSERT(std::any_of(g.begin(), g.end(), [&n] (auto const& e) { return &n == &e.first || &n == &e.second; }));
 
+  const std::vector<std::vector<int>> adj{{1, 2}, {2}, {}};
+  for (auto [to, repr] : out_edges(adj, 0))
+    ASSERT(to == *repr);
 }
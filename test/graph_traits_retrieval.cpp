@@ -6,9 +6,62 @@
 //
 
 #include "femto_test.hpp"
+#include <bxlx/graph>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+struct sorted_graph : std::vector<std::vector<int>> {
+  using std::vector<std::vector<int>>::vector;
+};
+
+struct sorted_rows_traits : bxlx::graph::graph_traits<std::vector<std::vector<int>>> {};
+}
+
+template<>
+constexpr bool bxlx::graph::sorted_adjacency_v<sorted_graph> = true;
+
+template<>
+constexpr bool bxlx::graph::sorted_adjacency_v<std::vector<std::vector<int>>, sorted_rows_traits> = true;
 
 TEST(check_node_exists) {
+  using namespace bxlx::graph;
+  const std::map<std::string, std::set<std::string, std::less<>>, std::less<>> g{{"a", {"b", "c"}}, {"b", {"c"}}, {"c", {}}};
+  const std::map<std::string, std::pair<std::vector<std::string>, int>, std::less<>> weighted{{"a", {{"b"}, 1}}, {"b", {{}, 2}}};
+  const std::map<std::string, std::vector<std::string>> plain{{"a", {"b"}}, {"b", {}}};
+
+  S_ASSERT(detail::is_transparent_node_key_v<decltype(g), graph_traits<decltype(g)>, std::string_view> &&
+           !detail::is_transparent_node_key_v<decltype(plain), graph_traits<decltype(plain)>, std::string_view>);
 
+  ASSERT(has_node(g, std::string_view{"a"}) && !has_node(g, std::string_view{"d"}));
+  ASSERT(std::size(*adjacents(&g, std::string_view{"a"})) == 2 && adjacents(&g, std::string_view{"d"}) == nullptr);
+  ASSERT(get_edge(g, std::string_view{"a"}, "c") != invalid_edge(g));
+  ASSERT(get_edge(g, "b", std::string_view{"a"}) == invalid_edge(g));
+  ASSERT(node_property(weighted, std::string_view{"b"}) == 2 && *node_property(&weighted, "a") == 1);
+  ASSERT(get_edge(weighted, std::string_view{"a"}, "b") != invalid_edge(weighted));
+
+  ASSERT(has_node(plain, "a") && get_edge(plain, "a", "b") != invalid_edge(plain));
+
+  // the unordered containers have no comparator, they drop out of the heterogeneous lookups
+  const std::unordered_map<std::string, std::vector<std::string>> hashed{{"a", {"b"}}, {"b", {}}};
+  const std::vector<std::unordered_set<int>> hashed_rows{{1}, {0}};
+  S_ASSERT(!detail::is_transparent_node_key_v<decltype(hashed), graph_traits<decltype(hashed)>, std::string_view>);
+  ASSERT(has_node(hashed, "a") && !has_node(hashed, "c") && get_edge(hashed, "a", "b") != invalid_edge(hashed));
+  ASSERT(has_edge(hashed_rows, 0, 1) && !has_edge(hashed_rows, 1, 1));
+
+  const std::vector<std::vector<int>> indexed{{1}, {}};
+  ASSERT(has_node(indexed, 1) && !has_node(indexed, 2) && !has_node(indexed, -1));
+  ASSERT(adjacents(&indexed, -1) == nullptr && adjacents(&indexed, 0) != nullptr);
 }
 
 TEST(check_node_exists_comp) {
@@ -16,7 +69,88 @@ TEST(check_node_exists_comp) {
 }
 
 TEST(check_edge_exists_by_node) {
+  using namespace bxlx::graph;
+  const std::vector<std::vector<int>> unsorted{{3, 1, 2}, {0}, {}, {1}};
+  const sorted_graph sorted{{1, 2, 3}, {0}, {}, {1}};
+  const std::vector<std::set<int>> sets{{1, 2, 3}, {0}, {}, {1}};
+  const std::vector<std::vector<std::pair<int, double>>> with_props{{{1, .5}, {2, .5}, {3, .5}}, {{0, 1.}}, {}, {{1, 2.}}};
+
+  S_ASSERT(!sorted_adjacency_v<std::vector<std::vector<int>>>);
+  S_ASSERT(sorted_adjacency_v<sorted_graph>);
+  S_ASSERT(sorted_adjacency_v<std::vector<std::set<int>>>);
+
+  for (int from = 0; from < 4; ++from) {
+    for (int to = 0; to < 4; ++to) {
+      const bool expected = sets[from].count(to) > 0;
+      ASSERT(has_edge(unsorted, from, to) == expected);
+      ASSERT(has_edge(sorted, from, to) == expected);
+      ASSERT(has_edge(sets, from, to) == expected);
+      ASSERT(has_edge(with_props, from, to) == expected);
+    }
+  }
+
+  const std::pair<int, int> queries[]{{0, 3}, {3, 1}, {0, 0}, {2, 1}, {0, 1}, {1, 0}, {3, 2}};
+  const std::vector<bool> expected{true, true, false, false, true, true, false};
+  std::vector<bool> found;
+  has_edges(unsorted, std::begin(queries), std::end(queries), std::back_inserter(found));
+  ASSERT(found == expected);
+  found.clear();
+  has_edges(sorted, std::begin(queries), std::end(queries), std::back_inserter(found));
+  ASSERT(found == expected);
+  found.clear();
+  has_edges(sets, std::begin(queries), std::end(queries), std::back_inserter(found));
+  ASSERT(found == expected);
+  found.clear();
+  has_edges<std::vector<std::vector<int>>, graph_traits<std::vector<std::vector<int>>>>(
+        unsorted, std::begin(queries), std::end(queries), std::back_inserter(found));
+  ASSERT(found == expected);
+  const std::vector<std::vector<int>> sorted_rows(sorted.begin(), sorted.end());
+  found.clear();
+  has_edges<std::vector<std::vector<int>>, sorted_rows_traits>(
+        sorted_rows, std::begin(queries), std::end(queries), std::back_inserter(found));
+  ASSERT(found == expected);
+  for (auto [from, to] : queries)
+    ASSERT((has_edge<std::vector<std::vector<int>>, sorted_rows_traits>(sorted_rows, from, to)) == (sets[from].count(to) > 0));
 
+  const std::vector<std::pair<int, int>> edges{{0, 3}, {0, 1}, {3, 1}, {0, 2}, {1, 0}, {0, 1}};
+  found.clear();
+  has_edges(edges, std::begin(queries), std::end(queries), std::back_inserter(found));
+  ASSERT(found == expected);
+  std::vector<std::vector<std::pair<int, int>>::const_iterator> edge_reprs;
+  get_edges(edges, std::begin(queries), std::begin(queries) + 2, std::back_inserter(edge_reprs));
+  get_edges(edges, std::begin(queries), std::end(queries), std::back_inserter(edge_reprs));
+  ASSERT(edge_reprs.size() == 2 + std::size(queries));
+  for (std::size_t i{}; i < edge_reprs.size(); ++i)
+    ASSERT(edge_reprs[i] == get_edge(edges, queries[i < 2 ? i : i - 2].first, queries[i < 2 ? i : i - 2].second));
+
+  std::vector<std::vector<int>::const_iterator> reprs;
+  get_edges(unsorted, std::begin(queries), std::end(queries), std::back_inserter(reprs));
+  ASSERT(reprs.size() == std::size(queries));
+  for (std::size_t i{}; i < reprs.size(); ++i)
+    ASSERT(reprs[i] == get_edge(unsorted, queries[i].first, queries[i].second));
+
+  std::vector<std::vector<std::uint32_t>> wide(40);
+  std::vector<std::vector<short>> narrow(40);
+  std::vector<std::vector<long long>> longs(40);
+  for (std::uint32_t to = 39; to > 0; --to) {
+    wide[0].push_back(to);
+    narrow[0].push_back(static_cast<short>(to));
+    longs[0].push_back(to);
+  }
+  for (int to = 0; to < 40; ++to) {
+    ASSERT(has_edge(wide, 0, to) == (to > 0) && has_edge(narrow, 0, to) == (to > 0) && has_edge(longs, 0, to) == (to > 0));
+    if (to > 0)
+      ASSERT(*get_edge(wide, 0, to) == static_cast<std::uint32_t>(to) && *get_edge(longs, 0, to) == to);
+  }
+  ASSERT(!has_edge(wide, 1, 0) && !has_edge(narrow, 0, 40));
+
+  // the constant evaluation does not take the vector search
+  constexpr std::array<std::array<int, 2>, 3> fixed{{{1, 2}, {2, 0}, {0, 1}}};
+  S_ASSERT(has_edge(fixed, 0, 2) && !has_edge(fixed, 2, 2));
+  ASSERT(has_edge(fixed, 1, 0) && !has_edge(fixed, 1, 1));
+
+  ASSERT(detail::adjacency_rows_sorted<const sorted_graph, graph_traits<sorted_graph>>(sorted));
+  ASSERT(!detail::adjacency_rows_sorted<const std::vector<std::vector<int>>, graph_traits<std::vector<std::vector<int>>>>(unsorted));
 }
 
 TEST(check_edge_exists_by_edge_index) {
@@ -29,4 +163,28 @@ TEST(check_traits_containers) {
 
 TEST(check_traits_properties) {
 
-}
\ No newline at end of file
+}
+
+TEST(check_operation_costs) {
+  using namespace bxlx::graph;
+  using adj_list = std::vector<std::vector<int>>;
+  using adj_sets = std::map<std::string, std::set<std::string>>;
+  using edge_list = std::vector<std::pair<int, int>>;
+  using ordered_edges = std::set<std::pair<int, int>>;
+  using matrix = std::vector<std::bitset<64>>;
+
+  S_ASSERT(out_edges_cost_v<adj_list> == cost_t::constant && out_edges_cost_v<adj_sets> == cost_t::logarithmic);
+  S_ASSERT(out_edges_cost_v<matrix> == cost_t::nodes && out_edges_cost_v<edge_list> == cost_t::edges);
+  S_ASSERT(out_edges_cost_v<ordered_edges> == cost_t::logarithmic);
+
+  S_ASSERT(in_edges_cost_v<adj_list> == cost_t::edges && in_edges_cost_v<matrix> == cost_t::nodes);
+
+  S_ASSERT(has_edge_cost_v<adj_list> == cost_t::degree && has_edge_cost_v<sorted_graph> == cost_t::logarithmic);
+  S_ASSERT(has_edge_cost_v<adj_list, sorted_rows_traits> == cost_t::logarithmic);
+  S_ASSERT(has_edge_cost_v<adj_sets> == cost_t::logarithmic && has_edge_cost_v<matrix> == cost_t::constant);
+  S_ASSERT(has_edge_cost_v<edge_list> == cost_t::edges && has_edge_cost_v<ordered_edges> == cost_t::logarithmic);
+
+  S_ASSERT(node_count_cost_v<adj_list> == cost_t::constant && node_count_cost_v<std::bitset<16>> == cost_t::constant);
+  S_ASSERT(node_count_cost_v<edge_list> == cost_t::edges);
+  S_ASSERT(out_edges_cost_v<adj_list> < cost_t::edges && cost_t::degree < cost_t::nodes);
+}